@@ -0,0 +1,37 @@
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<long> allocations{0};
+thread_local int robot_depth = 0;
+
+void* allocate(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed) && robot_depth == 0) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+}
+
+namespace AllocTracker {
+
+void enable(bool on) {counting.store(on);}
+void reset() {allocations.store(0);}
+long count() {return allocations.load();}
+
+RobotScope::RobotScope() {robot_depth++;}
+RobotScope::~RobotScope() {robot_depth--;}
+
+}
+
+// Global replacements: array and nothrow forms forward to these in libstdc++
+void* operator new(std::size_t size) {return allocate(size);}
+void operator delete(void* memory) noexcept {std::free(memory);}
+void operator delete(void* memory, std::size_t) noexcept {std::free(memory);}
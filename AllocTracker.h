@@ -0,0 +1,21 @@
+#pragma once
+
+// Counts heap allocations made by the engine so tests can check that a round
+// in steady state never touches the heap. Counting is off until enabled.
+namespace AllocTracker {
+
+void enable(bool on);
+void reset();
+long count();
+
+// Allocations made by robot code are not the engine's to remove: the engine
+// wraps every robot callback in a RobotScope and those are not counted.
+class RobotScope {
+public:
+    RobotScope();
+    ~RobotScope();
+    RobotScope(const RobotScope&) = delete;
+    RobotScope& operator=(const RobotScope&) = delete;
+};
+
+}
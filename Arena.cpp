@@ -1,142 +1,276 @@
 #include "Arena.h"
+#include "Renderer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <stdexcept>
 #include <iostream>
-#include <cstdlib>
-#include <ctime>
-#include <iomanip>
 
 Arena::Arena(const GameConfig& config, const std::vector<std::shared_ptr<RobotBase>>& robots) 
     : rows_(config.rows), cols_(config.cols), 
-      grid_(config.rows, std::vector<char>(config.cols, '.')),
-      show_grid_numbers_(config.show_grid_numbers) {
+      grid_(config.rows * config.cols, '.'),
+      occupancy_(config.rows * config.cols, -1),
+      show_grid_numbers_(config.show_grid_numbers),
+      seed_(config.seed ? config.seed : Rng::randomSeed()),
+      rng_(seed_) {
     
-    std::cout << "Initializing Arena " << rows_ << "x" << cols_ << std::endl;
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+    // Row lines are cols_ long, all other line families are indexed by row
+    line_words_[ROW_LINE] = (cols_ + 63) / 64;
+    line_words_[COL_LINE] = line_words_[DIAG_LINE] = line_words_[ANTI_DIAG_LINE] = (rows_ + 63) / 64;
+    line_bits_[ROW_LINE].assign(rows_ * line_words_[ROW_LINE], 0);
+    line_bits_[COL_LINE].assign(cols_ * line_words_[COL_LINE], 0);
+    line_bits_[DIAG_LINE].assign((rows_ + cols_ - 1) * line_words_[DIAG_LINE], 0);
+    line_bits_[ANTI_DIAG_LINE].assign((rows_ + cols_ - 1) * line_words_[ANTI_DIAG_LINE], 0);
     
-    placeObstacles(config);
+    // Pages of about a thousand cells, at least one row
+    rows_per_page_ = std::max(1, std::min(rows_, SNAPSHOT_PAGE_CELLS / std::max(cols_, 1)));
+    int pages = (rows_ + rows_per_page_ - 1) / rows_per_page_;
+    page_base_.resize(pages);
+    page_dirty_.assign(pages, 1);
+    
+    LOG_INFO(LogEvent::ArenaInit, rows_, cols_, seed_ >> 32, seed_ & 0xFFFFFFFF);
+    
+    std::string error = placementError(config, robots.size());
+    if (!error.empty()) {throw std::invalid_argument(error);}
+    
+    Placement placement;
+    placement.requested = config.mounds + config.pits + config.flamethrowers + robots.size();
+    placeObstacles(config, placement);
+    
+    robots_.reserve(robots.size());
+    robot_rows_.reserve(robots.size());
+    robot_cols_.reserve(robots.size());
+    robot_health_.reserve(robots.size());
+    robot_on_flame_.reserve(robots.size());
+    alive_ids_.reserve(robots.size());
     
     // Add all robots passed from main
     for (auto& robot : robots) {
-        addRobot(robot);
+        addRobot(robot, placement);
+    }
+}
+
+std::string Arena::placementError(const GameConfig& config, size_t robot_count) {
+    if (config.rows <= 0 || config.cols <= 0) {
+        return "Arena must be at least 1x1, got " + std::to_string(config.rows) + "x" + std::to_string(config.cols);
     }
+    if (config.mounds < 0 || config.pits < 0 || config.flamethrowers < 0) {
+        return "Obstacle counts cannot be negative";
+    }
+    long long cells = static_cast<long long>(config.rows) * config.cols;
+    long long wanted = static_cast<long long>(config.mounds) + config.pits + config.flamethrowers + robot_count;
+    if (wanted > cells) {
+        return "Arena " + std::to_string(config.rows) + "x" + std::to_string(config.cols) + " has " +
+               std::to_string(cells) + " cells but " + std::to_string(wanted) +
+               " obstacles and robots were requested";
+    }
+    return "";
 }
 
 Arena::~Arena() {
-    std::cout << "Cleaning up Arena..." << std::endl;
+    LOG_INFO(LogEvent::ArenaCleanup);
 }
 
-void Arena::placeObstacles(const GameConfig& config) {
-    std::cout << "Generating obstacles: " 
-              << config.mounds << " mounds, "
-              << config.pits << " pits, "
-              << config.flamethrowers << " flamethrowers" << std::endl;
-    
-    int counter = 0;
-    while (counter < config.mounds) {
-        int r = std::rand() % rows_; int c = std::rand() % cols_;
-        if (grid_[r][c] == '.') {
-            grid_[r][c] = 'M';
-            counter++;
+// Uniform pick among the free cells. While under three quarters of the arena is
+// taken, rejection sampling against the grid needs at most four tries on average
+// and touches nothing else. Past that, the cells for every remaining placement are
+// chosen in one sequential pass over the grid (selection sampling; the pass is
+// O(cells) = O(placements) at that density) and Fisher-Yates shuffled, so a
+// crowded arena costs no more per placement and never stalls.
+int Arena::pickFreeCell(Placement& placement) {
+    int total = rows_ * cols_;
+    if (placement.chosen.empty() && placement.placed * 4LL < total * 3LL) {
+        placement.placed++;
+        while (true) {
+            int cell = rng_.below(total);
+            if (grid_[cell] == '.') {return cell;}
         }
     }
-    counter = 0;
-    while (counter < config.pits) {
-        int r = std::rand() % rows_; int c = std::rand() % cols_;
-        if (grid_[r][c] == '.') {
-            grid_[r][c] = 'P';
-            counter++;
+    
+    if (placement.chosen.empty()) {
+        int needed = placement.requested - placement.placed;
+        int free = total - placement.placed;
+        placement.chosen.reserve(needed);
+        for (int cell = 0; cell < total && needed > 0; cell++) {
+            if (grid_[cell] != '.') {continue;}
+            if (static_cast<int>(rng_.below(free)) < needed) {
+                placement.chosen.push_back(cell);
+                needed--;
+            }
+            free--;
+        }
+        for (int i = placement.chosen.size() - 1; i > 0; i--) {
+            std::swap(placement.chosen[i], placement.chosen[rng_.below(i + 1)]);
         }
     }
-    counter = 0;
-    while (counter < config.flamethrowers) {
-        int r = std::rand() % rows_; int c = std::rand() % cols_;
-        if (grid_[r][c] == '.') {
-            grid_[r][c] = 'F'; 
-            counter++;
+    placement.placed++;
+    int cell = placement.chosen.back();
+    placement.chosen.pop_back();
+    return cell;
+}
+
+void Arena::placeObstacles(const GameConfig& config, Placement& placement) {
+    LOG_INFO(LogEvent::ObstaclesPlaced, config.mounds, config.pits, config.flamethrowers);
+    
+    const std::pair<int, char> kinds[] = {{config.mounds, 'M'}, {config.pits, 'P'}, {config.flamethrowers, 'F'}};
+    for (const auto& [count, type] : kinds) {
+        for (int i = 0; i < count; i++) {
+            int cell = pickFreeCell(placement);
+            setCell(cell / cols_, cell % cols_, type);
         }
     }
 }
 
-void Arena::addRobot(std::shared_ptr<RobotBase> robot) {
+void Arena::addRobot(std::shared_ptr<RobotBase> robot, Placement& placement) {
     if (!robot) return;
-    int r = std::rand() % rows_; int c = std::rand() % cols_;
-    while (grid_[r][c] != '.') {r = std::rand() % rows_; c = std::rand() % cols_;}
+    int cell = pickFreeCell(placement);
+    int r = cell / cols_; int c = cell % cols_;
     robot->set_boundaries(rows_, cols_);
     robot->move_to(r, c);
-    RobotInfo info;
-    info.id = robots_.size();
-    info.row = r; info.col = c; info.on_flamethrower = false;
-    info.robot = robot;
-    robot_positions_.push_back(info);
+    int id = robots_.size();
     robots_.push_back(robot);
-    std::cout << "Placed robot " << robot->m_name 
-              << " at (" << r << ", " << c << ")"
-              << " with character '" << robot->m_character << "'" << std::endl;
+    robot_rows_.push_back(r);
+    robot_cols_.push_back(c);
+    robot_health_.push_back(robot->get_health());
+    robot_on_flame_.push_back(false);
+    if (robot->get_health() > 0) alive_ids_.push_back(id);
+    LOG_INFO(LogEvent::RobotPlaced, id, r, c, robot->m_character);
     
-    grid_[r][c] = robot->m_character;
+    setCell(r, c, robot->m_character);
+    occupancy_[r * cols_ + c] = id;
 }
 
-void Arena::printArena() const {
-    std::cout << "\n=== ARENA STATE ===\n";
-    
-    // Column headers - each column number takes 3 spaces
-    std::cout << "  ";
-    for (int c = 0; c < cols_; ++c) {std::cout << std::setw(3) << c;}
-    std::cout << "\n";
-    
-    // Top border
-    std::cout << "  +";
-    for (int c = 0; c < cols_; ++c) {std::cout << "---";}
-    std::cout << "+\n";
-    
-    // Grid
-    for (int r = 0; r < rows_; ++r) {
-        std::cout << std::setw(2) << r << "|";
-        for (int c = 0; c < cols_; ++c) {
-            char cell = grid_[r][c];
-            
-            // Check if there's a robot at this position
-            bool is_robot = false;
-            bool is_alive = false;
-            bool on_fire = false;
-            if ((cell != '.') && (cell != 'M') && (cell != 'P') && (cell != 'F')) {
-                for (const auto& info : robot_positions_) {
-                    if (info.row == r && info.col == c) {
-                        is_robot = true;
-                        is_alive = (info.robot->get_health() > 0);
-                        on_fire = info.on_flamethrower;
-                        break;
-                    }
-                }
+ArenaSnapshot Arena::takeSnapshot() {
+    ArenaSnapshot snapshot;
+    snapshot.rows = rows_;
+    snapshot.cols = cols_;
+    
+    snapshot.grid_pages.resize(page_base_.size());
+    for (size_t page = 0; page < page_base_.size(); page++) {
+        if (page_dirty_[page] || !page_base_[page]) {
+            int first = page * rows_per_page_ * cols_;
+            int last = std::min<int>(first + rows_per_page_ * cols_, grid_.size());
+            auto copy = std::make_shared<ArenaSnapshot::GridPage>();
+            copy->cells.assign(grid_.begin() + first, grid_.begin() + last);
+            copy->occupancy.assign(occupancy_.begin() + first, occupancy_.begin() + last);
+            page_base_[page] = std::move(copy);
+            page_dirty_[page] = 0;
+        }
+        snapshot.grid_pages[page] = page_base_[page];
+    }
+    
+    // Robot stats change behind the arena's back (grenades, pits), so robot pages
+    // are compared against the previous snapshot rather than dirty-tracked
+    int robot_count = robots_.size();
+    int robot_pages = (robot_count + ArenaSnapshot::ROBOTS_PER_PAGE - 1) / ArenaSnapshot::ROBOTS_PER_PAGE;
+    robot_page_base_.resize(robot_pages);
+    snapshot.robot_pages.resize(robot_pages);
+    for (int page = 0; page < robot_pages; page++) {
+        int first = page * ArenaSnapshot::ROBOTS_PER_PAGE;
+        int last = std::min(first + ArenaSnapshot::ROBOTS_PER_PAGE, robot_count);
+        const auto& base = robot_page_base_[page];
+        bool changed = !base;
+        for (int id = first; id < last && !changed; id++) {
+            changed = !(robotState(id) == base->robots[id - first]);
+        }
+        if (changed) {
+            auto copy = std::make_shared<ArenaSnapshot::RobotPage>();
+            copy->robots.reserve(last - first);
+            for (int id = first; id < last; id++) {copy->robots.push_back(robotState(id));}
+            robot_page_base_[page] = std::move(copy);
+        }
+        snapshot.robot_pages[page] = robot_page_base_[page];
+    }
+    return snapshot;
+}
+
+bool Arena::fitsSnapshot(const ArenaSnapshot& snapshot) const {
+    if (snapshot.rows != rows_ || snapshot.cols != cols_ || snapshot.grid_pages.size() != page_base_.size()) {
+        return false;
+    }
+    for (size_t page = 0; page < page_base_.size(); page++) {
+        const auto& saved = snapshot.grid_pages[page];
+        size_t cells = static_cast<size_t>(std::min<int>(rows_per_page_, rows_ - page * rows_per_page_)) * cols_;
+        if (!saved || saved->cells.size() != cells || saved->occupancy.size() != cells) {return false;}
+    }
+    
+    int robot_count = robots_.size();
+    int robot_pages = (robot_count + ArenaSnapshot::ROBOTS_PER_PAGE - 1) / ArenaSnapshot::ROBOTS_PER_PAGE;
+    if (static_cast<int>(snapshot.robot_pages.size()) != robot_pages) {return false;}
+    for (int page = 0; page < robot_pages; page++) {
+        const auto& saved = snapshot.robot_pages[page];
+        int first = page * ArenaSnapshot::ROBOTS_PER_PAGE;
+        int robots = std::min(ArenaSnapshot::ROBOTS_PER_PAGE, robot_count - first);
+        if (!saved || static_cast<int>(saved->robots.size()) != robots) {return false;}
+    }
+    return true;
+}
+
+bool Arena::restoreSnapshot(const ArenaSnapshot& snapshot) {
+    if (!fitsSnapshot(snapshot)) {return false;}
+    
+    for (size_t page = 0; page < page_base_.size(); page++) {
+        const auto& saved = snapshot.grid_pages[page];
+        if (!page_dirty_[page] && page_base_[page] == saved) {continue;}
+        
+        // The line index follows the cells that change between empty and occupied
+        int first = page * rows_per_page_ * cols_;
+        for (size_t i = 0; i < saved->cells.size(); i++) {
+            if ((grid_[first + i] == '.') != (saved->cells[i] == '.')) {
+                toggleLineBits((first + i) / cols_, (first + i) % cols_);
             }
+        }
+        std::copy(saved->cells.begin(), saved->cells.end(), grid_.begin() + first);
+        std::copy(saved->occupancy.begin(), saved->occupancy.end(), occupancy_.begin() + first);
+        page_base_[page] = saved;
+        page_dirty_[page] = 0;
+    }
+    
+    bool exact = true;
+    robot_page_base_.resize(snapshot.robot_pages.size());
+    for (size_t page = 0; page < snapshot.robot_pages.size(); page++) {
+        const auto& saved = snapshot.robot_pages[page];
+        int first = page * ArenaSnapshot::ROBOTS_PER_PAGE;
+        for (size_t i = 0; i < saved->robots.size(); i++) {
+            int id = first + i;
+            const ArenaSnapshot::RobotState& state = saved->robots[i];
+            if (robotState(id) == state) {continue;}
+            
+            RobotBase& robot = *robots_[id];
+            robot.move_to(state.row, state.col);
+            robot_rows_[id] = state.row;
+            robot_cols_[id] = state.col;
+            robot_on_flame_[id] = state.on_flamethrower;
             
-            // Display
-            // Change this section in printArena():
-            if (is_robot) {
-                if (is_alive) {
-                    if (on_fire) {std::cout << "f" << cell << "f";  // Robot on flamethrower
-                    } else {std::cout << "<" << cell << ">";}  // Normal robot
-                } else {std::cout << "x" << cell << "x";}  // Dead robot
-            } else {std::cout << " " << cell << " ";}
+            // take_damage and reduce_armor only clamp at zero, so negative amounts heal
+            robot.take_damage(robot.get_health() - state.health);
+            robot.reduce_armor(robot.get_armor() - state.armor);
+            updateRobotHealth(id, state.health);
+            while (robot.get_grenades() > state.grenades) {robot.decrement_grenades();}
+            if (state.move == 0) {robot.disable_movement();}
+            exact = exact && robot.get_grenades() == state.grenades && robot.get_move_speed() == state.move;
         }
-        std::cout << "|" << r << "\n";
+        robot_page_base_[page] = saved;
     }
+    return exact;
+}
 
-    // Bottom border
-    std::cout << "  +";
-    for (int c = 0; c < cols_; ++c) {
-        std::cout << "---";
-    }
-    std::cout << "+\n";
-    std::cout << "  ";
-    for (int c = 0; c < cols_; ++c) {std::cout << std::setw(3) << c;}
-    std::cout << "\n";
+ArenaSnapshot::RobotState Arena::robotState(int robot_id) const {
+    RobotBase& robot = *robots_[robot_id];
+    return {robot_rows_[robot_id], robot_cols_[robot_id], robot.get_health(), robot.get_armor(),
+            robot.get_move_speed(), robot.get_grenades(), robot_on_flame_[robot_id] != 0};
+}
+
+void Arena::printArena() const {
+    // One-off frame; EventHandler keeps its own renderer for the per-round view
+    Renderer renderer(rows_, cols_, false);
+    renderer.drawArena(*this);
+    renderer.present();
 }
 
 void Arena::printRobotInfo() const {
     std::cout << "\n=== ROBOT STATUS ===\n";
     for (size_t i = 0; i < robots_.size(); ++i) {
         const auto& robot = robots_[i];
-        const auto& pos = robot_positions_[i];
         
         std::cout << "Robot " << i << ": " << robot->m_name << ", Char: '" << robot->m_character << "'\n";
         std::cout << " Stats: " << robot->print_stats() << "\n";
@@ -144,26 +278,80 @@ void Arena::printRobotInfo() const {
     }
 }
 
-void Arena::setCell(int row, int col, char val) {grid_[row][col] = val;}
-char Arena::getCell(int row, int col) const {return grid_[row][col];}
+void Arena::toggleLineBits(int row, int col) {
+    const int lines[LINE_KINDS] = {row, col, row - col + cols_ - 1, row + col};
+    const int positions[LINE_KINDS] = {col, row, row, row};
+    for (int kind = 0; kind < LINE_KINDS; ++kind) {
+        int pos = positions[kind];
+        line_bits_[kind][lines[kind] * line_words_[kind] + pos / 64] ^= (uint64_t(1) << (pos % 64));
+    }
+}
+
+int Arena::nextOccupied(int row, int col, int dir_row, int dir_col) const {
+    // Pick the line family the ray runs along and where the ray sits on it
+    int kind, line, pos, step;
+    if (dir_row == 0)            {kind = ROW_LINE;       line = row;               pos = col; step = dir_col;}
+    else if (dir_col == 0)       {kind = COL_LINE;       line = col;               pos = row; step = dir_row;}
+    else if (dir_row == dir_col) {kind = DIAG_LINE;      line = row - col + cols_ - 1; pos = row; step = dir_row;}
+    else                         {kind = ANTI_DIAG_LINE; line = row + col;         pos = row; step = dir_row;}
+    
+    const uint64_t* words = &line_bits_[kind][line * line_words_[kind]];
+    int word_index = pos / 64;
+    int found;
+    if (step > 0) {
+        uint64_t word = words[word_index] & (~uint64_t(0) << (pos % 64));
+        while (word == 0) {
+            if (++word_index == line_words_[kind]) {return -1;}
+            word = words[word_index];
+        }
+        found = word_index * 64 + __builtin_ctzll(word);
+    } else {
+        uint64_t word = words[word_index] & (~uint64_t(0) >> (63 - pos % 64));
+        while (word == 0) {
+            if (--word_index < 0) {return -1;}
+            word = words[word_index];
+        }
+        found = word_index * 64 + 63 - __builtin_clzll(word);
+    }
+    // Only in-arena cells are ever set, so the hit is always on the board
+    return (found - pos) * step;
+}
 
 bool Arena::updateRobotPosition(int robot_id, int new_row, int new_col, bool on_flamethrower) {
-    if (robot_id < 0 || robot_id >= robot_positions_.size()) {return false;}
+    if (robot_id < 0 || robot_id >= static_cast<int>(robots_.size())) {return false;}
     
     if (new_row < 0 || new_row >= rows_ || new_col < 0 || new_col >= cols_) {return false;}
     
-    auto& robot_info = robot_positions_[robot_id];
+    // Restore the cell being left (flamethrowers survive robots standing on them)
+    int old_row = robot_rows_[robot_id], old_col = robot_cols_[robot_id];
+    setCell(old_row, old_col, robot_on_flame_[robot_id] ? 'F' : '.');
+    occupancy_[old_row * cols_ + old_col] = -1;
     
     // Update robot's internal location
-    robot_info.robot->move_to(new_row, new_col);
+    robots_[robot_id]->move_to(new_row, new_col);
     
     // Update tracking info
-    robot_info.row = new_row;
-    robot_info.col = new_col;
-    robot_info.on_flamethrower = on_flamethrower;
+    robot_rows_[robot_id] = new_row;
+    robot_cols_[robot_id] = new_col;
+    robot_on_flame_[robot_id] = on_flamethrower;
     
     // Update grid
-    grid_[new_row][new_col] = robot_info.robot->m_character;
+    setCell(new_row, new_col, robots_[robot_id]->m_character);
+    occupancy_[new_row * cols_ + new_col] = robot_id;
     
     return true;
+}
+
+void Arena::updateRobotHealth(int robot_id, int health) {
+    bool was_alive = robot_health_[robot_id] > 0;
+    robot_health_[robot_id] = health;
+    if (was_alive == (health > 0)) {return;}
+    
+    // Deaths are rare next to turns, so the sorted list is patched in place
+    auto position = std::lower_bound(alive_ids_.begin(), alive_ids_.end(), robot_id);
+    if (was_alive) {
+        alive_ids_.erase(position);
+    } else {
+        alive_ids_.insert(position, robot_id);
+    }
 }
\ No newline at end of file
@@ -1,9 +1,14 @@
 #pragma once
 
 #include "RobotBase.h"
+#include "ArenaSnapshot.h"
 #include "Config.h"
+#include "Rng.h"
 #include <vector>
+#include <algorithm>
 #include <memory>
+#include <cstdint>
+#include <string>
 
 class Arena {
 private:
@@ -12,24 +17,49 @@ private:
     int cols_;
     
     // Display grid ('.' = empty, 'M'/'P'/'F' = obstacles, letters = robots)
-    std::vector<std::vector<char>> grid_;
+    // stored row-major in one buffer: cell (r, c) lives at r * cols_ + c
+    std::vector<char> grid_;
+
+    // Occupancy layer parallel to grid_: robot id standing in each cell, -1 if none
+    std::vector<int> occupancy_;
+    
+    // Per-line index of non-empty cells: one bitset for every row, column,
+    // diagonal (row - col constant) and anti-diagonal (row + col constant).
+    // Rows are indexed by column, every other line family by row.
+    enum LineKind { ROW_LINE, COL_LINE, DIAG_LINE, ANTI_DIAG_LINE, LINE_KINDS };
+    std::vector<uint64_t> line_bits_[LINE_KINDS];
+    int line_words_[LINE_KINDS];
     
     // Display setting from config
     bool show_grid_numbers_;
     
-    // Robot tracking
-    struct RobotInfo {
-        int id;
-        int row;
-        int col;
-        bool on_flamethrower;
-        std::shared_ptr<RobotBase> robot;
-    };
-    std::vector<RobotInfo> robot_positions_;
+    // Placement randomness, seeded from config (or at random when it is 0)
+    uint64_t seed_;
+    Rng rng_;
+    
+    // Robot tracking: the robots themselves, plus the engine's hot per-robot
+    // state as parallel arrays indexed by robot id, so bookkeeping that sweeps
+    // every robot stays in a few contiguous arrays instead of chasing pointers
     std::vector<std::shared_ptr<RobotBase>> robots_;
+    std::vector<int> robot_rows_;
+    std::vector<int> robot_cols_;
+    std::vector<int> robot_health_;        // mirror of RobotBase health, see updateRobotHealth
+    std::vector<uint8_t> robot_on_flame_;
+    
+    // Live robot ids in ascending order; deaths are removed as they happen
+    std::vector<int> alive_ids_;
+    
+    // Snapshot bookkeeping. The grid is paged in bands of whole rows; for each
+    // page, the last snapshot page known to match it (null before the first
+    // snapshot) and whether a setCell has touched it since.
+    int rows_per_page_;
+    std::vector<std::shared_ptr<const ArenaSnapshot::GridPage>> page_base_;
+    std::vector<uint8_t> page_dirty_;
+    std::vector<std::shared_ptr<const ArenaSnapshot::RobotPage>> robot_page_base_;
 
 public:
-    // Constructor takes config AND pre-loaded robots
+    // Constructor takes config AND pre-loaded robots. Throws std::invalid_argument
+    // when the obstacles and robots do not fit (see placementError).
     Arena(const GameConfig& config, const std::vector<std::shared_ptr<RobotBase>>& robots);
     ~Arena();
     
@@ -38,16 +68,72 @@ public:
     
     // Getters
     bool updateRobotPosition(int robot_id, int new_row, int new_col, bool on_flamethrower);
+    // Call after anything changes a robot's health; keeps the mirror and the
+    // alive list in step (a robot brought back above 0 rejoins the list)
+    void updateRobotHealth(int robot_id, int health);
     int getRows() const { return rows_; }
     int getCols() const { return cols_; }
-    char getCell(int row, int col) const;
-    void setCell(int row, int col, char val);
+    uint64_t getSeed() const { return seed_; }
+    char getCell(int row, int col) const { return grid_[row * cols_ + col]; }
+    void setCell(int row, int col, char val) {
+        char& cell = grid_[row * cols_ + col];
+        if ((cell == '.') != (val == '.')) {toggleLineBits(row, col);}
+        cell = val;
+        page_dirty_[row / rows_per_page_] = 1;
+    }
+    int getRobotAt(int row, int col) const { return occupancy_[row * cols_ + col]; }
     const std::vector<std::shared_ptr<RobotBase>>& getRobots() const { return robots_; }
-    const std::vector<RobotInfo>& getRobotPositions() const { return robot_positions_; }
+    int getRobotCount() const { return robots_.size(); }
+    int getRobotRow(int robot_id) const { return robot_rows_[robot_id]; }
+    int getRobotCol(int robot_id) const { return robot_cols_[robot_id]; }
+    int getRobotHealth(int robot_id) const { return robot_health_[robot_id]; }
+    bool isOnFlamethrower(int robot_id) const { return robot_on_flame_[robot_id]; }
+    bool isAlive(int robot_id) const { return robot_health_[robot_id] > 0; }
+    int getAliveCount() const { return alive_ids_.size(); }
+    const std::vector<int>& getAliveRobots() const { return alive_ids_; }
+    
+    // Steps from (row, col) along (dir_row, dir_col) to the first non-empty cell,
+    // counting (row, col) itself as step 0. Returns -1 if the ray leaves the arena first.
+    int nextOccupied(int row, int col, int dir_row, int dir_col) const;
+    // Steps from (row, col) along (dir_row, dir_col) to the last cell inside the arena
+    int stepsToEdge(int row, int col, int dir_row, int dir_col) const {
+        int steps = rows_ + cols_;
+        if (dir_row != 0) {steps = dir_row > 0 ? rows_ - 1 - row : row;}
+        if (dir_col != 0) {steps = std::min(steps, dir_col > 0 ? cols_ - 1 - col : col);}
+        return steps;
+    }
     void printRobotInfo() const;
+    
+    // Snapshots of the grid, occupancy and every robot's position and stats.
+    // Taking one copies only the pages changed since the last snapshot; restoring
+    // rewrites only pages that differ from the snapshot, so both cost about as
+    // much as what changed in between. restoreSnapshot returns false when some
+    // robot could not be put back exactly: RobotBase has no way to give back
+    // grenades or movement once lost, so those stay as they are now. Robots'
+    // own memory (and an isolated robot's view of its stats) is never restored.
+    // A snapshot that does not fit this arena (see fitsSnapshot) is refused
+    // with false before anything changes.
+    ArenaSnapshot takeSnapshot();
+    bool restoreSnapshot(const ArenaSnapshot& snapshot);
+    // Same size, page layout and robot count as this arena
+    bool fitsSnapshot(const ArenaSnapshot& snapshot) const;
+    
+    // Why the config cannot place its obstacles plus 'robot_count' robots, or "" if it can
+    static std::string placementError(const GameConfig& config, size_t robot_count);
 
 private:
     // Internal methods
-    void placeObstacles(const GameConfig& config);
-    void addRobot(std::shared_ptr<RobotBase> robot);
+    // Setup-time state for handing out free cells
+    struct Placement {
+        int requested;              // obstacles plus robots
+        int placed = 0;
+        std::vector<int> chosen;    // cells left for the remaining placements, once crowded
+    };
+    int pickFreeCell(Placement& placement);
+    void placeObstacles(const GameConfig& config, Placement& placement);
+    void addRobot(std::shared_ptr<RobotBase> robot, Placement& placement);
+    void toggleLineBits(int row, int col);
+    ArenaSnapshot::RobotState robotState(int robot_id) const;
+    
+    static constexpr int SNAPSHOT_PAGE_CELLS = 1024;
 };
\ No newline at end of file
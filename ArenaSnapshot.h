@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Rng.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Captured match state (see Arena::takeSnapshot and EventHandler::takeSnapshot).
+// The grid and the robot table are split into immutable pages shared between
+// snapshots: a page that did not change since the previous snapshot is the same
+// page, so a snapshot only pays for the regions that moved.
+struct ArenaSnapshot {
+    // A band of whole grid rows: display cells and the occupancy layer
+    struct GridPage {
+        std::vector<char> cells;
+        std::vector<int> occupancy;
+    };
+    
+    // What the engine knows about a robot (its own decision-making state is not here)
+    struct RobotState {
+        int row, col;
+        int health, armor, move, grenades;
+        bool on_flamethrower;
+        
+        bool operator==(const RobotState&) const = default;
+    };
+    static constexpr int ROBOTS_PER_PAGE = 64;
+    struct RobotPage {
+        std::vector<RobotState> robots;
+    };
+    
+    // Size of the arena it was taken from; a snapshot only restores into the same size
+    int rows = 0;
+    int cols = 0;
+    
+    std::vector<std::shared_ptr<const GridPage>> grid_pages;
+    std::vector<std::shared_ptr<const RobotPage>> robot_pages;
+    
+    // Damage rolls still to come; set by EventHandler::takeSnapshot
+    Rng damage_rng = Rng(0);
+};
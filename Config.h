@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -12,17 +13,70 @@ struct GameConfig {
     int max_rounds = 100;
     bool watch_live = true;
     int turn_delay_ms = 500;
+    // Simultaneous turns (--simultaneous): every robot decides against the arena as
+    // it stood at the start of the round, then shots and moves are resolved
+    bool simultaneous_turns = false;
     
     // Obstacles
     int mounds = 5*area/100;
     int pits = 2*area/100;
     int flamethrowers = 1*area/100;
     
+    // Radar: when sparse, scans only report occupied cells (obstacles and robots),
+    // in the same order a full scan would list them
+    bool sparse_radar = false;
+    
+    // Match seed for placement and damage rolls (0 = pick one at random);
+    // the same seed and robots replay the same match
+    uint64_t seed = 0;
+    
+    // Replay recording (empty = off); a full keyframe every N rounds
+    std::string replay_file = "";
+    int replay_keyframe_interval = 50;
+    
+    // Live stream of the match on a Unix socket (--spectate PATH, empty = off);
+    // clients further behind than the backlog limit are disconnected
+    std::string spectator_socket = "";
+    int spectator_max_backlog_kb = 1024;
+    
+    // Tournament
+    int worker_threads = 0;       // 0 = one per hardware thread
+    int watch_matches = 20;       // --watch: quick matches per opponent after each rebuild
+    
+    // Head-to-head SPRT (--sprt NEW OLD): H0 = NEW is sprt_elo0 stronger, H1 = sprt_elo1
+    // stronger; alpha/beta are the false H1/H0 acceptance rates
+    double sprt_elo0 = 0.0;
+    double sprt_elo1 = 50.0;
+    double sprt_alpha = 0.05;
+    double sprt_beta = 0.05;
+    int sprt_batch = 32;          // matches per parallel batch between checks
+    int sprt_min_matches = 64;    // no decision before this many, so the prior alone never decides
+    int sprt_max_matches = 20000;
+    
+    // Isolation (--isolate): each robot runs in its own forked process; a callback
+    // that takes longer than the budget forfeits the robot's turn
+    bool isolate_robots = false;
+    int robot_call_budget_ms = 50;
+    int robot_memory_limit_mb = 512;    // extra address space an isolated robot may map (0 = no cap)
+    
+    // Time every robot callback and report per-robot latency after the match (--profile)
+    bool profile_robots = false;
+    
     // Robot loading
     std::string robot_directory = ".";
     
+    // Robot builds (--build-robots): Robot_*.cpp in robot_directory compile into
+    // content-hash-named libraries here, and only when an input changed
+    std::string robot_cache_directory = "robot_cache";
+    std::string robot_base_object = "obj/RobotBase.o";
+    std::string robot_compiler = "g++";
+    std::string robot_compile_flags = "-std=c++20 -fPIC";
+    
     // Display
     bool show_grid_numbers = true;
-    bool verbose_logging = false;
+    // Live view redraws only changed cells with ANSI cursor moves; a frame that
+    // follows log lines or other output on std::cout is drawn in full
+    bool ansi_diff_render = false;
+    bool verbose_logging = false;  // per-turn engine events (moves, shots); hits and setup always log
 
 };
\ No newline at end of file
@@ -1,20 +1,72 @@
 // EventHandler.cpp  
 #include "EventHandler.h"
+#include "AllocTracker.h"
+#include "Logger.h"
 #include <iostream>
+#include <numeric>
+#include <cstdio>
+#include <algorithm>
+#include <atomic>
 
-EventHandler::EventHandler(Arena& arena) : arena_(arena) {}
+namespace {
 
-std::vector<RadarObj> EventHandler::scanRadar(int robot_id, int direction) {
-    std::vector<RadarObj> radar_results;
+// 3-wide radar rays: offsets of the outer rays from the center ray
+constexpr std::pair<int, int> horizontal_offsets[] = {{-1, 0}, {0, 0}, {1, 0}};  // Up, center, down
+constexpr std::pair<int, int> vertical_offsets[] = {{0, -1}, {0, 0}, {0, 1}};    // Left, center, right
+constexpr std::pair<int, int> diagonal_offsets[] = {{-1, -1}, {0, 0}, {1, 1}};   // Both axes
+
+// Minor-axis offset of step k along a line whose major axis advances by 'major'
+// per 'minor', rounded to the nearest cell (halves away from zero)
+int roundedStep(int k, int minor, int major) {
+    int twice = 2 * k * minor;
+    return (twice + (twice < 0 ? -major : major)) / (2 * major);
+}
+
+}
+
+
+EventHandler::EventHandler(Arena& arena, const GameConfig& config)
+    : arena_(arena), sparse_radar_(config.sparse_radar),
+      simultaneous_(config.simultaneous_turns), pool_(nullptr),
+      renderer_(arena.getRows(), arena.getCols(), config.ansi_diff_render),
+      rng_(arena.getSeed(), 1), recorder_(nullptr), profiler_(nullptr) {
+    
+    // A dense scan sees at most 3 rays across the arena
+    int rows = arena_.getRows(), cols = arena_.getCols();
+    radar_results_.reserve(3 * (rows + cols) + 8);
+    
+    if (simultaneous_) {
+        size_t robot_count = arena_.getRobots().size();
+        robot_radar_.resize(robot_count);
+        for (auto& radar : robot_radar_) {radar.reserve(3 * (rows + cols) + 8);}
+        decisions_.resize(robot_count);
+    }
+    turn_order_.reserve(arena_.getRobots().size());
+    
+    // Longest path: a railgun line crossing the arena, or the 12-cell flame box
+    size_t longest_path = std::max(std::max(rows, cols), 12);
+    shot_paths_.resize(SHOT_PATH_SLOTS);
+    for (auto& slot : shot_paths_) {
+        slot.key = UINT64_MAX;
+        slot.offsets.reserve(longest_path);
+    }
+}
+
+const std::vector<RadarObj>& EventHandler::scanRadar(int robot_id, int direction) {
+    scanRadar(robot_id, direction, radar_results_);
+    return radar_results_;
+}
+
+void EventHandler::scanRadar(int robot_id, int direction, std::vector<RadarObj>& radar_results) const {
+    radar_results.clear();
     
-    if (direction < 0 || direction > 8) {return radar_results;}  // Invalid direction
+    if (direction < 0 || direction > 8) {return;}  // Invalid direction
     
     // Get robot position
-    const auto& robot_positions = arena_.getRobotPositions();
-    if (robot_id < 0 || robot_id >= robot_positions.size()) {return radar_results;}  // Invalid robot ID
+    if (robot_id < 0 || robot_id >= arena_.getRobotCount()) {return;}  // Invalid robot ID
     
-    int robot_row = robot_positions[robot_id].row;
-    int robot_col = robot_positions[robot_id].col;
+    int robot_row = arena_.getRobotRow(robot_id);
+    int robot_col = arena_.getRobotCol(robot_id);
     
     // Direction 0: 8 squares immediately surrounding the robot
     if (direction == 0) {
@@ -30,11 +82,12 @@ std::vector<RadarObj> EventHandler::scanRadar(int robot_id, int direction) {
                     target_col >= 0 && target_col < arena_.getCols()) {
                     
                     char cell_content = arena_.getCell(target_row, target_col);
+                    if (sparse_radar_ && cell_content == '.') continue;
                     radar_results.emplace_back(cell_content, target_row, target_col);
                 }
             }
         }
-        return radar_results;
+        return;
     }
     
     // Directions 1-8: 3-wide ray to edge of arena
@@ -46,22 +99,42 @@ std::vector<RadarObj> EventHandler::scanRadar(int robot_id, int direction) {
     // For cardinal directions (1,3,5,7), offset is perpendicular
     // For diagonal directions (2,4,6,8), offset is along both axes
     
-    std::vector<std::pair<int, int>> width_offsets;
+    const std::pair<int, int>* width_offsets;
     
     if (dir_row == 0 || dir_col == 0) {
         // Cardinal direction (up/down/left/right)
         if (dir_row == 0) {  // Horizontal (left/right)
-            width_offsets = {{-1, 0}, {0, 0}, {1, 0}};  // Up, center, down
+            width_offsets = horizontal_offsets;
         } else {  // Vertical (up/down)
-            width_offsets = {{0, -1}, {0, 0}, {0, 1}};  // Left, center, right
+            width_offsets = vertical_offsets;
         }
     } else {
         // Diagonal direction
-        width_offsets = {{-1, -1}, {0, 0}, {1, 1}};  // Both axes
+        width_offsets = diagonal_offsets;
     }
     
     // Trace each of the 3 rays
-    for (const auto& offset : width_offsets) {
+    for (int ray = 0; ray < 3; ray++) {
+        const auto& offset = width_offsets[ray];
+        if (sparse_radar_) {
+            // Jump from one occupied cell to the next using the arena's line index
+            int current_row = robot_row + dir_row + offset.first;
+            int current_col = robot_col + dir_col + offset.second;
+            while (current_row >= 0 && current_row < arena_.getRows() &&
+                   current_col >= 0 && current_col < arena_.getCols()) {
+                int steps = arena_.nextOccupied(current_row, current_col, dir_row, dir_col);
+                if (steps < 0) break;
+                current_row += steps * dir_row;
+                current_col += steps * dir_col;
+                if (current_row != robot_row || current_col != robot_col) {
+                    radar_results.emplace_back(arena_.getCell(current_row, current_col), current_row, current_col);
+                }
+                current_row += dir_row;
+                current_col += dir_col;
+            }
+            continue;
+        }
+        
         int current_row = robot_row + dir_row + offset.first;
         int current_col = robot_col + dir_col + offset.second;
         
@@ -77,24 +150,20 @@ std::vector<RadarObj> EventHandler::scanRadar(int robot_id, int direction) {
             current_col += dir_col;
         }
     }
-    return radar_results;
 }
 
 bool EventHandler::processMovement(int robot_id, int direction, int requested_distance) {
-    std::cout << "  [MOVE] Robot " << robot_id << " moving dir " << direction 
-              << " dist " << requested_distance << std::endl;
+    LOG_DEBUG(LogEvent::MoveRequest, robot_id, direction, requested_distance);
     
-    const auto& robot_positions = arena_.getRobotPositions();
-    if (robot_id < 0 || robot_id >= robot_positions.size()) {
+    if (robot_id < 0 || robot_id >= arena_.getRobotCount()) {
         return false;
     }
     
-    const auto& robot_info = robot_positions[robot_id];
-    auto robot = robot_info.robot;
+    const auto& robot = arena_.getRobots()[robot_id];
     
     // Check pit
     if (robot->get_move_speed() == 0) {
-        std::cout << "  [MOVE] Robot in pit, cannot move" << std::endl;
+        LOG_DEBUG(LogEvent::MoveInPit, robot_id);
         return false;
     }
     
@@ -109,86 +178,89 @@ bool EventHandler::processMovement(int robot_id, int direction, int requested_di
     int dir_row = directions[direction].first;
     int dir_col = directions[direction].second;
     
-    int current_row = robot_info.row;
-    int current_col = robot_info.col;
-    bool current_on_flame = robot_info.on_flamethrower;
+    int current_row = arena_.getRobotRow(robot_id);
+    int current_col = arena_.getRobotCol(robot_id);
+    bool current_on_flame = arena_.isOnFlamethrower(robot_id);
     if (current_on_flame) {
-        int damage = 30 + (std::rand() % 21);
-            std::cout << "  [Robot really ended it's turn on a flamethrower??? Robot takes " << damage << " damage!" << std::endl;
-            robot->take_damage(damage);
+        int damage = rng_.range(30, 50);
+        LOG_INFO(LogEvent::FlameStanding, robot_id, damage);
+        int health = robot->take_damage(damage);
+        arena_.updateRobotHealth(robot_id, health);
+        if (recorder_) {
+            recorder_->recordDamage(robot_id, damage, health, robot->get_armor());
+            if (health == 0) recorder_->recordDeath(robot_id);
+        }
     }
     int steps_taken = 0;
+    int remaining = actual_distance;
     
-    for (int step = 1; step <= actual_distance; step++) {
+    // Jump from one non-empty cell to the next with the line index instead of
+    // stepping: the cells in between are empty, so only a mound or robot (stop
+    // short), a pit (stop in it) or a flamethrower (burn and carry on) matter
+    while (remaining > 0) {
         int next_row = current_row + dir_row;
         int next_col = current_col + dir_col;
-        
-        // Check bounds
-        if (next_row < 0 || next_row >= arena_.getRows() ||
-            next_col < 0 || next_col >= arena_.getCols()) {
+        if (next_row < 0 || next_row >= arena_.getRows() || next_col < 0 || next_col >= arena_.getCols()) {
             break;
         }
         
-        char cell_content = arena_.getCell(next_row, next_col);
-        
-        // Handle cell types
-        if ((cell_content != '.') && (cell_content != 'F') && (cell_content != 'P')) {
-            break;  // Stop at mounds/robots
+        // Empty steps before the edge or the next occupied cell
+        int hit = arena_.nextOccupied(next_row, next_col, dir_row, dir_col);
+        int empty = hit >= 0 ? hit : arena_.stepsToEdge(next_row, next_col, dir_row, dir_col) + 1;
+        int advance = std::min(empty, remaining);
+        if (advance > 0) {
+            current_row += advance * dir_row;
+            current_col += advance * dir_col;
+            current_on_flame = false;  // Not on flamethrower anymore
+            steps_taken += advance;
+            remaining -= advance;
         }
-        else if (cell_content == 'P') {
+        if (remaining == 0 || hit < 0) break;   // done, or stopped at the edge
+        
+        next_row = current_row + dir_row;
+        next_col = current_col + dir_col;
+        char cell_content = arena_.getCell(next_row, next_col);
+        if (cell_content == 'P') {
             // Move onto pit
             current_row = next_row;
             current_col = next_col;
-            steps_taken = step;
+            steps_taken++;
             robot->disable_movement();  // Trap in pit
+            if (recorder_) recorder_->recordStats(robot_id, *robot);
             break;
         }
-        else if (cell_content == 'F') {
-            // Move onto flamethrower
-            current_row = next_row;
-            current_col = next_col;
-            current_on_flame = true;
-            steps_taken = step;
-            
-            // Take damage
-            int damage = 30 + (std::rand() % 21);
-            std::cout << "  [MOVE] Robot takes " << damage << " flamethrower damage!" << std::endl;
-            robot->take_damage(damage);
-            
-            continue;  // Can continue moving from flamethrower
-        }
-        else if (cell_content >= 'A' && cell_content <= 'Z') {
-            break;  // Stop at other robots
-        }
-        else if (cell_content == '.') {
-            current_row = next_row;
-            current_col = next_col;
-            current_on_flame = false;  // Not on flamethrower anymore
-            steps_taken = step;
-            continue;
-        }
-        else {
-            break;  // Unknown cell
+        if (cell_content != 'F') break;  // Stop at mounds and robots (live or dead)
+        
+        // Move onto flamethrower and take damage
+        current_row = next_row;
+        current_col = next_col;
+        current_on_flame = true;
+        steps_taken++;
+        remaining--;
+        int damage = rng_.range(30, 50);
+        LOG_INFO(LogEvent::FlameDamage, robot_id, damage);
+        int health = robot->take_damage(damage);
+        arena_.updateRobotHealth(robot_id, health);
+        if (recorder_) {
+            recorder_->recordDamage(robot_id, damage, health, robot->get_armor());
+            if (health == 0) recorder_->recordDeath(robot_id);
         }
     }
     
     // If robot moved, update position
     if (steps_taken > 0) {
-        // Clear old position
-        if (robot_info.on_flamethrower) {
-            arena_.setCell(robot_info.row, robot_info.col, 'F');  // Restore flamethrower
-        } else {
-            arena_.setCell(robot_info.row, robot_info.col, '.');  // Restore empty
-        }
+        int from_row = arena_.getRobotRow(robot_id);
+        int from_col = arena_.getRobotCol(robot_id);
+        char restored = arena_.isOnFlamethrower(robot_id) ? 'F' : '.';
         
-        // Update robot tracking (need mutable access)
-        // We'll need to add a method to Arena to update robot position
+        // Arena restores the old cell and moves the robot in the occupancy layer
         bool success = arena_.updateRobotPosition(robot_id, current_row, current_col, current_on_flame);
         
         if (success) {
-            std::cout << "  [MOVE] Moved to (" << current_row << "," << current_col << ")";
-            if (current_on_flame) std::cout << " (on flamethrower)";
-            std::cout << std::endl;
+            if (recorder_) {
+                recorder_->recordMove(robot_id, from_row, from_col, current_row, current_col, restored, current_on_flame);
+            }
+            LOG_DEBUG(LogEvent::Moved, robot_id, current_row, current_col, current_on_flame);
             return true;
         }
     }
@@ -196,38 +268,254 @@ bool EventHandler::processMovement(int robot_id, int direction, int requested_di
     return false;
 }
 
+const std::vector<std::pair<int, int>>& EventHandler::getShotPath(WeaponType weapon, int delta_row, int delta_col) {
+    // Lines only depend on the direction of the shot, grenades land on the exact target
+    if (weapon != grenade) {
+        int divisor = std::gcd(delta_row, delta_col);
+        delta_row /= divisor;
+        delta_col /= divisor;
+    }
+    uint64_t key = (uint64_t(weapon) << 32) | (uint64_t(uint16_t(delta_row)) << 16) | uint16_t(delta_col);
+    ShotPathSlot& slot = shot_paths_[((key * 0x9E3779B97F4A7C15ULL) >> 32) % SHOT_PATH_SLOTS];
+    if (slot.key == key) {return slot.offsets;}
+    
+    // Miss: rebuild the slot in place (its storage was reserved up front)
+    slot.key = key;
+    std::vector<std::pair<int, int>>& path = slot.offsets;
+    path.clear();
+    if (weapon == grenade) {
+        // 3x3 blast centered on the target
+        for (int dr = -1; dr <= 1; dr++) {
+            for (int dc = -1; dc <= 1; dc++) {path.emplace_back(delta_row + dr, delta_col + dc);}
+        }
+        return path;
+    }
+    
+    // Step one cell at a time along the major axis toward the target
+    bool cols_major = std::abs(delta_col) >= std::abs(delta_row);
+    int major = cols_major ? std::abs(delta_col) : std::abs(delta_row);
+    int minor = cols_major ? delta_row : delta_col;
+    int major_step = cols_major ? (delta_col > 0 ? 1 : -1) : (delta_row > 0 ? 1 : -1);
+    
+    // Railgun goes to the edge (the walk stops once it leaves the arena),
+    // flamethrower reaches 4 cells and the hammer only the adjacent cell
+    int length = std::max(arena_.getRows(), arena_.getCols());
+    if (weapon == flamethrower) length = 4;
+    if (weapon == hammer) length = 1;
+    
+    for (int k = 1; k <= length; k++) {
+        int along = k * major_step;
+        int across = roundedStep(k, minor, major);
+        std::pair<int, int> cell = cols_major ? std::make_pair(across, along) : std::make_pair(along, across);
+        path.push_back(cell);
+        if (weapon == flamethrower) {
+            // Flame is 3 cells wide, spread across the major axis
+            if (cols_major) {
+                path.emplace_back(cell.first - 1, cell.second);
+                path.emplace_back(cell.first + 1, cell.second);
+            } else {
+                path.emplace_back(cell.first, cell.second - 1);
+                path.emplace_back(cell.first, cell.second + 1);
+            }
+        }
+    }
+    return path;
+}
+
+void EventHandler::applyHit(int target_id, int min_damage, int max_damage) {
+    auto& target = arena_.getRobots()[target_id];
+    
+    // Armor soaks 10% per level, then loses a level
+    int damage = rng_.range(min_damage, max_damage);
+    damage = damage * (10 - target->get_armor()) / 10;
+    int health = target->take_damage(damage);
+    target->reduce_armor(1);
+    arena_.updateRobotHealth(target_id, health);
+    
+    LOG_INFO(LogEvent::Hit, target_id, damage, health == 0);
+    if (recorder_) {
+        recorder_->recordDamage(target_id, damage, health, target->get_armor());
+        if (health == 0) recorder_->recordDeath(target_id);
+    }
+}
+
 bool EventHandler::processShot(int shooter_id, int target_row, int target_col) {
-    std::cout << "  TODO: Robot " << shooter_id 
-              << " shoots at (" << target_row << ", " << target_col << ")" << std::endl;
-    return false;
+    if (shooter_id < 0 || shooter_id >= arena_.getRobotCount()) {
+        return false;
+    }
+    
+    int shooter_row = arena_.getRobotRow(shooter_id);
+    int shooter_col = arena_.getRobotCol(shooter_id);
+    auto& shooter = arena_.getRobots()[shooter_id];
+    WeaponType weapon = shooter->get_weapon();
+    
+    LOG_DEBUG(LogEvent::ShotFired, shooter_id, weapon, target_row, target_col);
+    
+    int delta_row = target_row - shooter_row;
+    int delta_col = target_col - shooter_col;
+    if (delta_row == 0 && delta_col == 0) {
+        LOG_DEBUG(LogEvent::ShotAtSelf, shooter_id);
+        return false;
+    }
+    
+    if (weapon == grenade) {
+        if (shooter->get_grenades() <= 0) {
+            LOG_DEBUG(LogEvent::OutOfGrenades, shooter_id);
+            return false;
+        }
+        shooter->decrement_grenades();
+    }
+    
+    if (recorder_) {
+        recorder_->recordShot(shooter_id, target_row, target_col);
+        if (weapon == grenade) recorder_->recordStats(shooter_id, *shooter);
+    }
+    
+    int min_damage = 0, max_damage = 0;
+    switch (weapon) {
+        case railgun:      min_damage = 10; max_damage = 20; break;
+        case hammer:       min_damage = 50; max_damage = 60; break;
+        case grenade:      min_damage = 10; max_damage = 40; break;
+        case flamethrower: min_damage = 30; max_damage = 50; break;
+    }
+    
+    // Walk the cached path, hitting every live robot in it (except the shooter)
+    bool hit_any = false;
+    for (const auto& offset : getShotPath(weapon, delta_row, delta_col)) {
+        int row = shooter_row + offset.first;
+        int col = shooter_col + offset.second;
+        if (row < 0 || row >= arena_.getRows() || col < 0 || col >= arena_.getCols()) {
+            continue;
+        }
+        
+        int target_id = arena_.getRobotAt(row, col);
+        if (target_id < 0 || target_id == shooter_id) continue;
+        if (!arena_.isAlive(target_id)) continue;
+        
+        applyHit(target_id, min_damage, max_damage);
+        hit_any = true;
+    }
+    
+    if (!hit_any) {
+        LOG_DEBUG(LogEvent::ShotMissed, shooter_id);
+    }
+    return true;
 }
 
-void EventHandler::processRobotTurn(int robot_id, int round_number) {
-    std::cout << "\n  Processing turn for robot " << robot_id << std::endl;
+void EventHandler::decideTurn(int robot_id, TurnDecision& decision, std::vector<RadarObj>& radar_results) {
+    LOG_DEBUG(LogEvent::TurnStart, robot_id);
+    
+    // Robot callbacks are bracketed with RobotScope: what robots allocate is
+    // their own business, not the engine's. They are also timed when profiling.
     
     // 1. Get radar direction
-    int radar_dir = 0;
     auto& robot = arena_.getRobots()[robot_id];
-    robot->get_radar_direction(radar_dir);
+    decision = TurnDecision();
+    {
+        AllocTracker::RobotScope scope;
+        RobotProfiler::Timer timer(profiler_, robot_id, RobotProfiler::RADAR_DIRECTION);
+        robot->get_radar_direction(decision.radar_dir);
+    }
     
     // 2. Scan radar
-    auto radar_results = scanRadar(robot_id, radar_dir);
+    scanRadar(robot_id, decision.radar_dir, radar_results);
     
     // 3. Process radar results
-    robot->process_radar_results(radar_results);
+    {
+        AllocTracker::RobotScope scope;
+        RobotProfiler::Timer timer(profiler_, robot_id, RobotProfiler::RADAR_RESULTS);
+        robot->process_radar_results(radar_results);
+    }
     
     // 4. Get shot location
-    int shot_row = 0, shot_col = 0;
-    if (robot->get_shot_location(shot_row, shot_col)) {
-        processShot(robot_id, shot_row, shot_col);
-    } else {
-        // 5. Get movement
-        int move_dir = 0, move_dist = 0;
-        robot->get_move_direction(move_dir, move_dist);
-        if (move_dir != 0) {
-            processMovement(robot_id, move_dir, move_dist);
+    {
+        AllocTracker::RobotScope scope;
+        RobotProfiler::Timer timer(profiler_, robot_id, RobotProfiler::SHOT_LOCATION);
+        decision.shooting = robot->get_shot_location(decision.shot_row, decision.shot_col);
+    }
+    if (decision.shooting) return;
+    
+    // 5. Get movement
+    {
+        AllocTracker::RobotScope scope;
+        RobotProfiler::Timer timer(profiler_, robot_id, RobotProfiler::MOVE_DIRECTION);
+        robot->get_move_direction(decision.move_dir, decision.move_dist);
+    }
+}
+
+void EventHandler::processRobotTurn(int robot_id, int round_number) {
+    TurnDecision decision;
+    decideTurn(robot_id, decision, radar_results_);
+    if (recorder_) recorder_->recordRadar(robot_id, decision.radar_dir);
+    
+    if (decision.shooting) {
+        processShot(robot_id, decision.shot_row, decision.shot_col);
+    } else if (decision.move_dir != 0) {
+        processMovement(robot_id, decision.move_dir, decision.move_dist);
+    }
+}
+
+void EventHandler::playRound(int round_number) {
+    if (simultaneous_) {
+        playSimultaneousRound();
+        return;
+    }
+    // Robots destroyed earlier in the round lose their turn
+    turn_order_ = arena_.getAliveRobots();
+    for (int robot_id : turn_order_) {
+        if (arena_.isAlive(robot_id)) processRobotTurn(robot_id, round_number);
+    }
+}
+
+void EventHandler::playSimultaneousRound() {
+    turn_order_ = arena_.getAliveRobots();
+    
+    // Decide: robots only see the arena as it was at the start of the round.
+    // One task per worker pulling robots off a shared counter keeps the
+    // submissions few and small.
+    std::atomic<size_t> next(0);
+    auto decide = [this, &next] {
+        for (size_t k = next++; k < turn_order_.size(); k = next++) {
+            int robot_id = turn_order_[k];
+            decideTurn(robot_id, decisions_[robot_id], robot_radar_[robot_id]);
         }
+    };
+    if (pool_ && turn_order_.size() > 1) {
+        int tasks = std::min<size_t>(pool_->size(), turn_order_.size());
+        for (int t = 0; t < tasks; t++) {pool_->submit(decide);}
+        pool_->wait();
+    } else {
+        decide();
+    }
+    
+    // Resolve: every shot fires (including those of robots destroyed earlier in
+    // this round, which decided at the same time), then survivors move. Both
+    // in id order, so the same decisions always give the same outcome; when two
+    // robots head for one cell the lower id gets there first.
+    if (recorder_) {
+        for (int robot_id : turn_order_) {recorder_->recordRadar(robot_id, decisions_[robot_id].radar_dir);}
+    }
+    for (int robot_id : turn_order_) {
+        const TurnDecision& decision = decisions_[robot_id];
+        if (decision.shooting) processShot(robot_id, decision.shot_row, decision.shot_col);
     }
+    for (int robot_id : turn_order_) {
+        const TurnDecision& decision = decisions_[robot_id];
+        if (decision.shooting || decision.move_dir == 0 || !arena_.isAlive(robot_id)) continue;
+        processMovement(robot_id, decision.move_dir, decision.move_dist);
+    }
+}
+
+ArenaSnapshot EventHandler::takeSnapshot() {
+    ArenaSnapshot snapshot = arena_.takeSnapshot();
+    snapshot.damage_rng = rng_;
+    return snapshot;
+}
+
+bool EventHandler::restoreSnapshot(const ArenaSnapshot& snapshot) {
+    if (!arena_.fitsSnapshot(snapshot)) {return false;}
+    rng_ = snapshot.damage_rng;
+    return arena_.restoreSnapshot(snapshot);
 }
 
 bool EventHandler::checkForWinner() const {
@@ -235,77 +523,96 @@ bool EventHandler::checkForWinner() const {
 }
 
 int EventHandler::countAliveRobots() const {
-    int alive = 0;
-    for (const auto& robot : arena_.getRobots()) {
-        if (robot->get_health() > 0) {
-            alive++;
-        }
-    }
-    return alive;
+    return arena_.getAliveCount();
 }
 
 
 void EventHandler::printRoundHeader(int round_number, int max_rounds) const {
-    std::cout << "\n╔══════════════════════════════════════════════════════╗" << std::endl;
+    // The ANSI live view keeps the board in place; the round shows in the status block
+    if (renderer_.isAnsiDiff()) return;
+    
+    std::cout << "\n╔══════════════════════════════════════════════════════╗\n";
     std::cout << "║                    ROUND " << std::setw(3) << round_number 
-              << " / " << std::setw(3) << max_rounds << "                    ║" << std::endl;
-    std::cout << "╚══════════════════════════════════════════════════════╝" << std::endl;
+              << " / " << std::setw(3) << max_rounds << "                    ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════╝\n";
 }
 
-std::string EventHandler::formatRobotStats(RobotBase& robot) const {
-    std::stringstream ss;
-    ss << robot.m_name << " '" << robot.m_character << "'";
-    ss << " | H:" << std::setw(3) << robot.get_health();
-    ss << " A:" << std::setw(1) << robot.get_armor();
-    ss << " M:" << std::setw(1) << robot.get_move_speed();
-    ss << " W:" << robot.get_weapon();
-    if (robot.get_grenades() > 0) {
-        ss << " G:" << robot.get_grenades();
-    }
-    
+// Formats into the caller's buffer (truncating if needed) so printing stats every
+// round never allocates. Returns the number of characters written.
+int EventHandler::formatRobotStats(RobotBase& robot, char* buffer, size_t size) const {
     // Get robot position
     int row, col;
     robot.get_current_location(row, col);
-    ss << " @(" << row << "," << col << ")";
     
-    return ss.str();
+    int length;
+    if (robot.get_grenades() > 0) {
+        length = std::snprintf(buffer, size, "%s '%c' | H:%3d A:%d M:%d W:%d G:%d @(%d,%d)",
+                               robot.m_name.c_str(), robot.m_character, robot.get_health(),
+                               robot.get_armor(), robot.get_move_speed(), robot.get_weapon(),
+                               robot.get_grenades(), row, col);
+    } else {
+        length = std::snprintf(buffer, size, "%s '%c' | H:%3d A:%d M:%d W:%d @(%d,%d)",
+                               robot.m_name.c_str(), robot.m_character, robot.get_health(),
+                               robot.get_armor(), robot.get_move_speed(), robot.get_weapon(),
+                               row, col);
+    }
+    return std::min(length, static_cast<int>(size) - 1);
 }
 
-void EventHandler::printRobotStatus(int robot_id) const {
-    const auto& robots = arena_.getRobots();
-    const auto& positions = arena_.getRobotPositions();
-    
-    if (robot_id < 0 || robot_id >= robots.size()) {
-        return;
-    }
+// One status line ("  Robot N: <stats> [STATE]") without the newline
+int EventHandler::formatRobotStatus(int robot_id, char* buffer, size_t size) const {
+    const auto& robot = arena_.getRobots()[robot_id];
     
-    const auto& robot = robots[robot_id];
-    const auto& pos = positions[robot_id];
+    char stats[128];
+    formatRobotStats(*robot, stats, sizeof(stats));
     
-    std::cout << "  Robot " << robot_id << ": " << formatRobotStats(*robot);
-    
-    if (robot->get_health() <= 0) {
-        std::cout << " [DEAD]";
+    const char* state = "";
+    if (!arena_.isAlive(robot_id)) {
+        state = " [DEAD]";
     } else if (robot->get_move_speed() == 0) {
-        std::cout << " [TRAPPED IN PIT]";
-    } else if (pos.on_flamethrower) {
-        std::cout << " [ON FLAMETHROWER]";
+        state = " [TRAPPED IN PIT]";
+    } else if (arena_.isOnFlamethrower(robot_id)) {
+        state = " [ON FLAMETHROWER]";
     }
     
-    std::cout << std::endl;
+    int length = std::snprintf(buffer, size, "  Robot %d: %s%s", robot_id, stats, state);
+    return std::min(length, static_cast<int>(size) - 1);
 }
 
-void EventHandler::printGameState(int round_number) const {
-    // Print arena
-    arena_.printArena();
-    
-    std::cout << "\n════════════════════ ROBOT STATUS ════════════════════" << std::endl;
-    std::cout << "Round: " << round_number;
-    std::cout << " | Alive: " << countAliveRobots() << "/" << arena_.getRobots().size();
-    std::cout << std::endl;
+void EventHandler::printRobotStatus(int robot_id) const {
+    if (robot_id < 0 || robot_id >= arena_.getRobots().size()) {
+        return;
+    }
     
+    char line[192];
+    formatRobotStatus(robot_id, line, sizeof(line));
+    std::cout << line << std::endl;
+}
+
+void EventHandler::printGameState(int round_number) const {
+    // Let the log thread catch up so this round's events print above its frame
+    Logger::flush();
+    
+    // Compose arena and status into one frame, then write it once
+    renderer_.beginFrame();
+    renderer_.drawArena(arena_);
+    renderer_.beginStatus();
+    
+    renderer_.append("\n════════════════════ ROBOT STATUS ════════════════════\n");
+    renderer_.append("Round: ");
+    renderer_.appendInt(round_number);
+    renderer_.append(" | Alive: ");
+    renderer_.appendInt(countAliveRobots());
+    renderer_.append("/");
+    renderer_.appendInt(arena_.getRobots().size());
+    renderer_.append("\n");
+    
+    char line[192];
     for (size_t i = 0; i < arena_.getRobots().size(); ++i) {
-        printRobotStatus(i);
+        int length = formatRobotStatus(i, line, sizeof(line));
+        renderer_.append(line, length);
+        renderer_.append("\n");
     }
-    std::cout << std::endl;
+    renderer_.append("\n");
+    renderer_.present();
 }
\ No newline at end of file
@@ -3,18 +3,83 @@
 
 #include "Arena.h"
 #include "RadarObj.h"
+#include "Renderer.h"
+#include "Replay.h"
+#include "RobotProfiler.h"
+#include "ThreadPool.h"
 #include <vector>
 #include <iomanip>
+#include <cstdint>
+#include <cstddef>
 
 class EventHandler {
 private:
     Arena& arena_;
     
+    // Radar setting from config
+    bool sparse_radar_;
+    
+    // Radar results handed to robots, reused every scan
+    std::vector<RadarObj> radar_results_;
+    
+    // Everything a robot chose for one turn
+    struct TurnDecision {
+        int radar_dir = 0;
+        bool shooting = false;
+        int shot_row = 0, shot_col = 0;
+        int move_dir = 0, move_dist = 0;
+    };
+    
+    // Simultaneous turns: every live robot decides against the same arena state,
+    // then shots and moves are resolved. Each robot gets its own radar buffer so
+    // decisions can run in parallel; all of it is sized up front.
+    bool simultaneous_;
+    std::vector<std::vector<RadarObj>> robot_radar_;
+    std::vector<TurnDecision> decisions_;
+    ThreadPool* pool_;
+    
+    // Live robots at the start of the round being played
+    std::vector<int> turn_order_;
+    
+    // Shot paths as offsets from the shooter, computed once per (delta, weapon) and
+    // kept in a direct-mapped table. Every slot reserves room for the longest path
+    // up front so a cache miss refills a slot without touching the heap.
+    struct ShotPathSlot {
+        uint64_t key;
+        std::vector<std::pair<int, int>> offsets;
+    };
+    static constexpr int SHOT_PATH_SLOTS = 256;
+    std::vector<ShotPathSlot> shot_paths_;
+    
+    // Frame buffer for printGameState (display methods are const, the buffer is not)
+    mutable Renderer renderer_;
+    
+    // Damage rolls; a separate stream of the arena's seed
+    Rng rng_;
+    
+    // Optional match recording and callback timing (not owned)
+    ReplayRecorder* recorder_;
+    RobotProfiler* profiler_;
+    const std::vector<std::pair<int, int>>& getShotPath(WeaponType weapon, int delta_row, int delta_col);
+    void applyHit(int target_id, int min_damage, int max_damage);
+    // Runs the robot's callbacks; reads the arena but never changes it
+    void decideTurn(int robot_id, TurnDecision& decision, std::vector<RadarObj>& radar_results);
+    void playSimultaneousRound();
+    
 public:
-    EventHandler(Arena& arena);
+    EventHandler(Arena& arena, const GameConfig& config);
     
-    // Radar system
-    std::vector<RadarObj> scanRadar(int robot_id, int direction);
+    // Events are recorded while a recorder is set (nullptr stops recording)
+    void setRecorder(ReplayRecorder* recorder) { recorder_ = recorder; }
+    // Robot callbacks are timed while a profiler is set
+    void setProfiler(RobotProfiler* profiler) { profiler_ = profiler; }
+    // Simultaneous rounds run robot decisions on this pool while set (otherwise
+    // one after another, with the same result)
+    void setThreadPool(ThreadPool* pool) { pool_ = pool; }
+    
+    // Radar system (results stay valid until the next scan)
+    const std::vector<RadarObj>& scanRadar(int robot_id, int direction);
+    void scanRadar(int robot_id, int direction, std::vector<RadarObj>& radar_results) const;
     
     // Movement system
     bool processMovement(int robot_id, int direction, int distance);
@@ -24,6 +89,15 @@ public:
     
     // Turn processing
     void processRobotTurn(int robot_id, int round_number);
+    // One turn for every live robot: in id order, or all at once with
+    // simultaneous_turns (shots then moves, each in id order)
+    void playRound(int round_number);
+    
+    // Match snapshots: the arena's (see Arena::takeSnapshot) plus the damage roll
+    // stream, so replaying the same decisions from a restore gives the same rounds.
+    // Restoring while recording leaves the replay out of step with the match.
+    ArenaSnapshot takeSnapshot();
+    bool restoreSnapshot(const ArenaSnapshot& snapshot);
     
     // Game state
     bool checkForWinner() const;
@@ -33,5 +107,6 @@ public:
     void printGameState(int round_number) const;
     void printRobotStatus(int robot_id) const;
     void printRoundHeader(int round_number, int max_rounds) const;
-    std::string formatRobotStats(RobotBase& robot) const;
+    int formatRobotStats(RobotBase& robot, char* buffer, size_t size) const;
+    int formatRobotStatus(int robot_id, char* buffer, size_t size) const;
 };
@@ -0,0 +1,255 @@
+#pragma once
+
+// Distance fields over the arena for path finding. Header-only, so robots can
+// use it (see RobotToolkit.h) as well as the engine (--analyze).
+
+#include "RobotBase.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Shortest-path distance from every cell to the nearest goal, moving one step at
+// a time in the 8 'directions'. Each cell has a cost for stepping onto it (0 =
+// impassable); goals can always be stepped onto. Following direction() from any
+// cell walks a cheapest path to a goal.
+//
+// Cost and goal changes are batched and applied by update(). Only the cells
+// whose distance actually depends on a change are recomputed: the ones that lost
+// their shortest path are invalidated (in increasing distance order, keeping any
+// with an equally short alternative), then they and the changed cells are
+// re-solved with Dijkstra on a radix heap. A handful of changes on a 1000x1000
+// field costs microseconds, not a full recompute.
+class FlowField {
+public:
+    static constexpr uint32_t UNREACHABLE = UINT32_MAX;
+
+    // Step costs for the movement rules: mounds and robots stop movement, a pit
+    // traps a robot for good, flamethrowers burn (by default as much as 8 steps)
+    static uint8_t costOf(char cell, uint8_t flamethrower_cost = 8) {
+        switch (cell) {
+            case '.': return 1;
+            case 'F': return flamethrower_cost;
+            default:  return 0;    // 'M', 'P' and robots
+        }
+    }
+
+private:
+    // Monotone priority queue: every key pushed is at least the last key popped.
+    // Bucket i holds keys whose highest bit differing from that key is bit i-1.
+    class RadixHeap {
+    private:
+        std::vector<std::pair<uint32_t, int>> buckets_[33];
+        uint32_t last_ = 0;
+        size_t size_ = 0;
+
+        static int bucketOf(uint32_t key, uint32_t last) {
+            return key == last ? 0 : 32 - __builtin_clz(key ^ last);
+        }
+
+    public:
+        bool empty() const { return size_ == 0; }
+        void clear() {
+            for (auto& bucket : buckets_) bucket.clear();
+            last_ = 0;
+            size_ = 0;
+        }
+        void push(uint32_t key, int cell) {
+            buckets_[bucketOf(key, last_)].emplace_back(key, cell);
+            size_++;
+        }
+        std::pair<uint32_t, int> pop() {
+            if (buckets_[0].empty()) {
+                int i = 1;
+                while (buckets_[i].empty()) i++;
+                uint32_t smallest = UINT32_MAX;
+                for (const auto& entry : buckets_[i]) smallest = std::min(smallest, entry.first);
+                last_ = smallest;
+                for (const auto& entry : buckets_[i]) buckets_[bucketOf(entry.first, last_)].push_back(entry);
+                buckets_[i].clear();
+            }
+            auto entry = buckets_[0].back();
+            buckets_[0].pop_back();
+            size_--;
+            return entry;
+        }
+    };
+
+    int rows_;
+    int cols_;
+    std::vector<uint8_t> cost_;
+    std::vector<uint8_t> goal_;
+    std::vector<uint32_t> distance_;
+
+    // Cells changed since the last update, and the incremental repair's scratch
+    std::vector<int> changed_;
+    std::vector<uint8_t> is_changed_;
+    std::vector<uint8_t> invalid_;
+    std::vector<int> invalidated_;
+    RadixHeap heap_;
+    bool full_;     // everything needs solving (new field, or too many changes)
+
+    // Cost of stepping onto a cell
+    uint32_t enterCost(int cell) const { return goal_[cell] ? 1 : cost_[cell]; }
+
+    void markChanged(int cell) {
+        if (is_changed_[cell]) return;
+        is_changed_[cell] = 1;
+        changed_.push_back(cell);
+    }
+
+    template <typename Visit>
+    void forNeighbors(int cell, Visit visit) const {
+        int row = cell / cols_, col = cell % cols_;
+        for (int direction = 1; direction <= 8; direction++) {
+            int r = row + directions[direction].first, c = col + directions[direction].second;
+            if (r >= 0 && r < rows_ && c >= 0 && c < cols_) visit(r * cols_ + c);
+        }
+    }
+
+    // Cheapest way out of 'cell' through neighbors that are still valid
+    uint32_t bestThroughNeighbors(int cell) const {
+        uint32_t best = UNREACHABLE;
+        forNeighbors(cell, [&](int next) {
+            uint32_t step = enterCost(next);
+            if (step == 0 || invalid_[next] || distance_[next] == UNREACHABLE) return;
+            best = std::min(best, distance_[next] + step);
+        });
+        return best;
+    }
+
+    void solve() {
+        while (!heap_.empty()) {
+            auto [distance, cell] = heap_.pop();
+            if (distance != distance_[cell]) continue;    // stale entry
+            uint32_t step = enterCost(cell);
+            if (step == 0) continue;                      // nothing passes through
+            forNeighbors(cell, [&](int previous) {
+                if (!goal_[previous] && distance + step < distance_[previous]) {
+                    distance_[previous] = distance + step;
+                    heap_.push(distance + step, previous);
+                }
+            });
+        }
+    }
+
+    void solveAll() {
+        heap_.clear();
+        for (size_t cell = 0; cell < distance_.size(); cell++) {
+            distance_[cell] = goal_[cell] ? 0 : UNREACHABLE;
+            if (goal_[cell]) heap_.push(0, cell);
+        }
+        solve();
+    }
+
+    void repair() {
+        // 1. Invalidate, nearest first, every cell left without a neighbor that
+        //    still supports its distance. Only cells farther than an invalidated
+        //    one can have depended on it.
+        heap_.clear();
+        for (int cell : changed_) {
+            if (distance_[cell] != UNREACHABLE) heap_.push(distance_[cell], cell);
+            forNeighbors(cell, [&](int next) {
+                if (distance_[next] != UNREACHABLE) heap_.push(distance_[next], next);
+            });
+        }
+        while (!heap_.empty()) {
+            auto [distance, cell] = heap_.pop();
+            if (invalid_[cell] || distance != distance_[cell] || goal_[cell]) continue;
+            if (bestThroughNeighbors(cell) <= distance) continue;     // still supported (or about to improve)
+            invalid_[cell] = 1;
+            invalidated_.push_back(cell);
+            forNeighbors(cell, [&](int next) {
+                if (!invalid_[next] && distance_[next] != UNREACHABLE && distance_[next] > distance) {
+                    heap_.push(distance_[next], next);
+                }
+            });
+        }
+
+        // 2. Re-seed the invalidated cells from their valid neighbors, and let the
+        //    changed cells (new goals, cheaper cells) spread again
+        heap_.clear();
+        for (int cell : invalidated_) {
+            distance_[cell] = UNREACHABLE;
+            invalid_[cell] = 0;
+        }
+        for (int cell : invalidated_) {
+            distance_[cell] = bestThroughNeighbors(cell);
+            if (distance_[cell] != UNREACHABLE) heap_.push(distance_[cell], cell);
+        }
+        for (int cell : changed_) {
+            if (goal_[cell]) distance_[cell] = 0;
+            if (distance_[cell] != UNREACHABLE) heap_.push(distance_[cell], cell);
+        }
+        invalidated_.clear();
+        solve();
+    }
+
+public:
+    // Every cell starts passable at cost 1, with no goals
+    FlowField(int rows, int cols)
+        : rows_(rows), cols_(cols), cost_(rows * cols, 1), goal_(rows * cols, 0),
+          distance_(rows * cols, UNREACHABLE), is_changed_(rows * cols, 0), invalid_(rows * cols, 0),
+          full_(true) {}
+
+    int getRows() const { return rows_; }
+    int getCols() const { return cols_; }
+
+    void setCost(int row, int col, uint8_t cost) {
+        int cell = row * cols_ + col;
+        if (cost_[cell] == cost) return;
+        cost_[cell] = cost;
+        markChanged(cell);
+    }
+    void setGoal(int row, int col, bool goal) {
+        int cell = row * cols_ + col;
+        if (goal_[cell] == goal) return;
+        goal_[cell] = goal;
+        markChanged(cell);
+    }
+    void clearGoals() {
+        for (size_t cell = 0; cell < goal_.size(); cell++) {
+            if (goal_[cell]) setGoal(cell / cols_, cell % cols_, false);
+        }
+    }
+
+    // Makes the next update() recompute every distance from scratch
+    void invalidate() { full_ = true; }
+
+    // Brings distances up to date with every setCost/setGoal since the last call
+    void update() {
+        // Past this many changes one full pass is cheaper than repairing
+        if (full_ || changed_.size() * 16 > cost_.size()) {
+            solveAll();
+        } else if (!changed_.empty()) {
+            repair();
+        }
+        for (int cell : changed_) is_changed_[cell] = 0;
+        changed_.clear();
+        full_ = false;
+    }
+
+    // Cost of the cheapest path to a goal (0 on a goal), UNREACHABLE if none
+    uint32_t distance(int row, int col) const { return distance_[row * cols_ + col]; }
+
+    // Direction (1-8) of the first step on a cheapest path, 0 on a goal or with no path
+    int direction(int row, int col) const {
+        int cell = row * cols_ + col;
+        if (goal_[cell]) return 0;
+        int best_direction = 0;
+        uint32_t best = UNREACHABLE;
+        for (int direction = 1; direction <= 8; direction++) {
+            int r = row + directions[direction].first, c = col + directions[direction].second;
+            if (r < 0 || r >= rows_ || c < 0 || c >= cols_) continue;
+            int next = r * cols_ + c;
+            uint32_t step = enterCost(next);
+            if (step == 0 || distance_[next] == UNREACHABLE) continue;
+            if (distance_[next] + step < best) {
+                best = distance_[next] + step;
+                best_direction = direction;
+            }
+        }
+        return best_direction;
+    }
+};
@@ -0,0 +1,303 @@
+#include "IsolatedRobot.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+enum CallKind { HELLO, RADAR_DIRECTION, RADAR_RESULTS, SHOT_LOCATION, MOVE_DIRECTION };
+
+// How long a robot may take to construct itself in the child
+constexpr int STARTUP_BUDGET_MS = 1000;
+
+// Longest single futex sleep while waiting on the child, so a dead child is noticed
+constexpr int WAIT_SLICE_MS = 10;
+
+}
+
+// Lives in a MAP_SHARED mapping created before the fork; the radar slots follow it
+struct IsolatedRobot::Channel {
+    std::atomic<uint32_t> request{0};         // sequence of the last call posted by the arena
+    std::atomic<uint32_t> reply{0};           // sequence of the last call the child answered
+    std::atomic<uint32_t> child_sleeping{0};
+    std::atomic<uint32_t> parent_sleeping{0};
+    
+    int kind = HELLO;
+    struct {
+        int row, col, health, armor, move, grenades, rows, cols;
+    } state = {};
+    int results[3] = {};
+    
+    // HELLO reply: what the child's robot looks like
+    int move = 0, armor = 0, weapon = 0;
+    char character = '?';
+    char name[64] = {};
+    
+    int radar_capacity = 0;
+    int radar_count = 0;
+    
+    RadarObj* radar() { return reinterpret_cast<RadarObj*>(this + 1); }
+};
+
+namespace {
+
+using Channel = IsolatedRobot::Channel;
+
+long futex(std::atomic<uint32_t>& word, int op, uint32_t value, const timespec* timeout = nullptr) {
+    // Shared futex (no FUTEX_PRIVATE_FLAG): the word is mapped in two processes
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, value, timeout, nullptr, 0);
+}
+
+// Spinning only pays off when the other side can run at the same time
+int spinLimit() {
+    static const int limit = std::thread::hardware_concurrency() > 1 ? 4000 : 0;
+    return limit;
+}
+
+enum WaitResult { REPLIED, TIMED_OUT, DIED };
+
+WaitResult awaitReply(Channel* channel, uint32_t sequence, int budget_ms, pid_t& pid) {
+    for (int i = 0; i < spinLimit(); i++) {
+        if (channel->reply.load(std::memory_order_acquire) == sequence) return REPLIED;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget_ms);
+    while (true) {
+        uint32_t reply = channel->reply.load();
+        if (reply == sequence) return REPLIED;
+        
+        auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds(0)) return TIMED_OUT;
+        if (waitpid(pid, nullptr, WNOHANG) == pid) {
+            pid = -1;
+            return DIED;
+        }
+        
+        long nanoseconds = std::min<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count(),
+                                          WAIT_SLICE_MS * 1000000L);
+        timespec timeout = {nanoseconds / 1000000000L, nanoseconds % 1000000000L};
+        channel->parent_sleeping.store(1);
+        if (channel->reply.load() == reply) futex(channel->reply, FUTEX_WAIT, reply, &timeout);
+        channel->parent_sleeping.store(0);
+    }
+}
+
+// Brings the child's copy of the robot in line with the arena's. Stats only
+// ever go down in a match, so the public final methods are enough.
+void applyState(RobotBase& robot, const Channel& channel) {
+    const auto& state = channel.state;
+    robot.set_boundaries(state.rows, state.cols);
+    robot.move_to(state.row, state.col);
+    if (robot.get_health() > state.health) robot.take_damage(robot.get_health() - state.health);
+    if (robot.get_armor() > state.armor) robot.reduce_armor(robot.get_armor() - state.armor);
+    while (robot.get_grenades() > state.grenades) robot.decrement_grenades();
+    if (state.move == 0 && robot.get_move_speed() != 0) robot.disable_movement();
+}
+
+// Address space the process already has mapped, so the limit only caps growth
+rlim_t mappedBytes() {
+    long pages = 0;
+    std::ifstream("/proc/self/statm") >> pages;
+    return static_cast<rlim_t>(pages) * sysconf(_SC_PAGESIZE);
+}
+
+[[noreturn]] void serve(Channel* channel, RobotFactory factory, pid_t parent, int memory_limit_mb) {
+    // Die with the forking thread; pool workers own their matches' robots, so
+    // this never outlives the robot's stand-in
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != parent) _exit(0);
+    
+    if (memory_limit_mb > 0) {
+        rlim_t bytes = mappedBytes() + (static_cast<rlim_t>(memory_limit_mb) << 20);
+        rlimit limit = {bytes, bytes};
+        setrlimit(RLIMIT_AS, &limit);
+    }
+    
+    RobotBase* robot = factory();
+    if (!robot) _exit(1);
+    std::vector<RadarObj> radar_results;
+    radar_results.reserve(channel->radar_capacity);
+    
+    uint32_t handled = 0;
+    while (true) {
+        for (int i = 0; channel->request.load(std::memory_order_acquire) == handled; i++) {
+            if (i < spinLimit()) continue;
+            channel->child_sleeping.store(1);
+            if (channel->request.load() == handled) futex(channel->request, FUTEX_WAIT, handled);
+            channel->child_sleeping.store(0);
+        }
+        handled = channel->request.load(std::memory_order_acquire);
+        
+        if (channel->kind != HELLO) applyState(*robot, *channel);
+        int* results = channel->results;
+        switch (channel->kind) {
+            case HELLO:
+                channel->move = robot->get_move_speed();
+                channel->armor = robot->get_armor();
+                channel->weapon = robot->get_weapon();
+                channel->character = robot->m_character;
+                std::snprintf(channel->name, sizeof(channel->name), "%s", robot->m_name.c_str());
+                break;
+            case RADAR_DIRECTION:
+                robot->get_radar_direction(results[0]);
+                break;
+            case RADAR_RESULTS:
+                radar_results.assign(channel->radar(), channel->radar() + channel->radar_count);
+                robot->process_radar_results(radar_results);
+                break;
+            case SHOT_LOCATION:
+                results[0] = robot->get_shot_location(results[1], results[2]);
+                break;
+            case MOVE_DIRECTION:
+                robot->get_move_direction(results[0], results[1]);
+                break;
+        }
+        
+        channel->reply.store(handled);
+        if (channel->parent_sleeping.load()) futex(channel->reply, FUTEX_WAKE, 1);
+    }
+}
+
+}
+
+IsolatedRobot::IsolatedRobot(Channel* channel, size_t channel_size, pid_t pid, int budget_ms,
+                             int move, int armor, WeaponType weapon)
+    : RobotBase(move, armor, weapon), channel_(channel), channel_size_(channel_size), pid_(pid),
+      budget_ms_(budget_ms), sequence_(channel ? channel->request.load() : 0),
+      stuck_(false), crashed_(channel == nullptr), forfeits_(0), turn_(0), forfeited_turn_(-1) {}
+
+IsolatedRobot::~IsolatedRobot() {
+    if (pid_ > 0) {
+        kill(pid_, SIGKILL);
+        waitpid(pid_, nullptr, 0);
+    }
+    if (channel_) munmap(channel_, channel_size_);
+}
+
+std::shared_ptr<RobotBase> IsolatedRobot::spawn(RobotFactory factory, const std::string& name, const GameConfig& config) {
+    // Enough radar slots for a dense scan, like EventHandler's own buffer
+    int capacity = 3 * (config.rows + config.cols) + 8;
+    size_t size = sizeof(Channel) + capacity * sizeof(RadarObj);
+    
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    pid_t pid = -1;
+    if (memory != MAP_FAILED) {
+        Channel* channel = new (memory) Channel();
+        channel->radar_capacity = capacity;
+        channel->request.store(1);    // HELLO is waiting for the child when it starts
+        
+        pid_t parent = getpid();
+        pid = fork();
+        if (pid == 0) serve(channel, factory, parent, config.robot_memory_limit_mb);
+        
+        if (pid > 0 && awaitReply(channel, 1, std::max(config.robot_call_budget_ms, STARTUP_BUDGET_MS), pid) == REPLIED) {
+            auto robot = std::shared_ptr<IsolatedRobot>(new IsolatedRobot(
+                channel, size, pid, config.robot_call_budget_ms,
+                channel->move, channel->armor, static_cast<WeaponType>(channel->weapon)));
+            robot->m_name = channel->name;
+            robot->m_character = channel->character;
+            return robot;
+        }
+        if (pid > 0) {
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+        }
+        munmap(memory, size);
+    }
+    
+    std::cerr << "  ERROR: could not start " << name << " in its own process; it starts destroyed" << std::endl;
+    auto robot = std::shared_ptr<IsolatedRobot>(new IsolatedRobot(nullptr, 0, -1, 0, 2, 0, railgun));
+    robot->m_name = name;
+    robot->m_character = '?';
+    robot->take_damage(robot->get_health());
+    return robot;
+}
+
+bool IsolatedRobot::ready() {
+    if (crashed_ || forfeited_turn_ == turn_) return false;
+    // Still busy with the call that overran: forfeit this turn without waiting again
+    if (stuck_ && channel_->reply.load(std::memory_order_acquire) != sequence_) {
+        forfeitTurn("is still busy with an overrun call");
+        return false;
+    }
+    stuck_ = false;
+    return true;
+}
+
+void IsolatedRobot::forfeitTurn(const char* reason) {
+    forfeited_turn_ = turn_;
+    std::cerr << m_name << ' ' << reason << "; forfeiting turn " << turn_ << std::endl;
+}
+
+bool IsolatedRobot::call(int kind) {
+    if (!ready()) {
+        forfeits_++;
+        return false;
+    }
+    
+    int row, col;
+    get_current_location(row, col);
+    channel_->state = {row, col, get_health(), get_armor(), get_move_speed(), get_grenades(),
+                       m_board_row_max, m_board_col_max};
+    channel_->kind = kind;
+    channel_->request.store(++sequence_);
+    if (channel_->child_sleeping.load()) futex(channel_->request, FUTEX_WAKE, 1);
+    
+    switch (awaitReply(channel_, sequence_, budget_ms_, pid_)) {
+        case REPLIED:
+            return true;
+        case TIMED_OUT:
+            stuck_ = true;
+            forfeitTurn(("overran its " + std::to_string(budget_ms_) + " ms budget").c_str());
+            break;
+        case DIED:
+            crashed_ = true;
+            std::cerr << m_name << "'s process died; it stays idle for the rest of the match" << std::endl;
+            break;
+    }
+    forfeits_++;
+    return false;
+}
+
+void IsolatedRobot::get_radar_direction(int& radar_direction) {
+    turn_++;
+    if (call(RADAR_DIRECTION)) radar_direction = channel_->results[0];
+}
+
+void IsolatedRobot::process_radar_results(const std::vector<RadarObj>& radar_results) {
+    if (!ready()) {
+        forfeits_++;
+        return;
+    }
+    int count = std::min<int>(radar_results.size(), channel_->radar_capacity);
+    std::copy(radar_results.begin(), radar_results.begin() + count, channel_->radar());
+    channel_->radar_count = count;
+    call(RADAR_RESULTS);
+}
+
+bool IsolatedRobot::get_shot_location(int& shot_row, int& shot_col) {
+    if (!call(SHOT_LOCATION) || !channel_->results[0]) return false;
+    shot_row = channel_->results[1];
+    shot_col = channel_->results[2];
+    return true;
+}
+
+void IsolatedRobot::get_move_direction(int& direction, int& distance) {
+    if (!call(MOVE_DIRECTION)) return;
+    direction = channel_->results[0];
+    distance = channel_->results[1];
+}
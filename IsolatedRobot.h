@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Config.h"
+#include "RobotBase.h"
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+// Stand-in for a robot that runs in a forked child process. The engine talks
+// to it like any other RobotBase; each callback is forwarded through a shared
+// memory mailbox together with the robot's current stats, and the child runs
+// the real robot against a mirrored copy of that state.
+//
+// Handoff is a sequence number per direction. Both sides spin briefly before
+// sleeping on a futex, and only wake the other side when it is actually asleep,
+// so a fast robot costs no system calls per callback.
+//
+// A callback that overruns robot_call_budget_ms forfeits the rest of the turn
+// (no radar, no shot, no move), even if the child catches up before the turn
+// is over. Turns are counted at get_radar_direction, the first callback of
+// every turn. While the child is still stuck on that call, later turns forfeit
+// at once instead of waiting again; every forfeited turn is logged. A child
+// that dies leaves the robot standing idle for the rest of the match.
+class IsolatedRobot : public RobotBase {
+public:
+    struct Channel;
+    
+private:
+    Channel* channel_;
+    size_t channel_size_;
+    pid_t pid_;
+    int budget_ms_;
+    
+    uint32_t sequence_;    // last call posted
+    bool stuck_;           // the last call overran its budget and is still running
+    bool crashed_;
+    int forfeits_;
+    int turn_;             // turns started so far
+    int forfeited_turn_;   // the turn whose remaining callbacks are refused, or -1
+    
+    IsolatedRobot(Channel* channel, size_t channel_size, pid_t pid, int budget_ms,
+                  int move, int armor, WeaponType weapon);
+    
+    // False while the child is dead, the current turn is forfeited, or the child
+    // is still busy with a call that overran
+    bool ready();
+    void forfeitTurn(const char* reason);
+    // Posts the call in the channel with the current stats; false means forfeit
+    bool call(int kind);
+    
+public:
+    ~IsolatedRobot() override;
+    
+    // Forks a process hosting a robot from 'factory'. If it does not come up,
+    // the stand-in enters the match already destroyed.
+    static std::shared_ptr<RobotBase> spawn(RobotFactory factory, const std::string& name, const GameConfig& config);
+    
+    // Callbacks skipped for overrunning the budget or a dead child
+    int getForfeits() const { return forfeits_; }
+    
+    void get_radar_direction(int& radar_direction) override;
+    void process_radar_results(const std::vector<RadarObj>& radar_results) override;
+    bool get_shot_location(int& shot_row, int& shot_col) override;
+    void get_move_direction(int& direction, int& distance) override;
+};
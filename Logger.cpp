@@ -0,0 +1,203 @@
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+struct Record {
+    std::atomic<uint64_t> sequence;
+    LogLevel level;
+    LogEvent event;
+    int32_t args[Logger::MAX_ARGS];
+};
+
+// Bounded multi-producer ring (sequence-numbered slots), one consumer thread
+constexpr uint64_t RING_SIZE = 1 << 14;
+
+class LogRing {
+public:
+    LogRing() {
+        for (uint64_t i = 0; i < RING_SIZE; i++) {slots_[i].sequence.store(i, std::memory_order_relaxed);}
+    }
+    
+    ~LogRing() {
+        if (thread_.joinable()) {
+            stop_.store(true);
+            thread_.join();
+        }
+    }
+    
+    void push(LogLevel level, LogEvent event, const int32_t* args, int count) {
+        std::call_once(started_, [this] { thread_ = std::thread(&LogRing::run, this); });
+        
+        uint64_t position = write_position_.load(std::memory_order_relaxed);
+        Record* slot;
+        while (true) {
+            slot = &slots_[position % RING_SIZE];
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            int64_t lag = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+            if (lag == 0) {
+                if (write_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (lag < 0) {
+                // Ring full: the consumer is behind, drop instead of waiting on it
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                position = write_position_.load(std::memory_order_relaxed);
+            }
+        }
+        
+        slot->level = level;
+        slot->event = event;
+        for (int i = 0; i < Logger::MAX_ARGS; i++) {slot->args[i] = (i < count) ? args[i] : 0;}
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+    
+    void flush() {
+        uint64_t target = write_position_.load(std::memory_order_acquire);
+        while (written_position_.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+    }
+    
+    uint64_t outputCount() const { return writes_.load(std::memory_order_acquire); }
+    
+private:
+    Record slots_[RING_SIZE];
+    std::atomic<uint64_t> write_position_{0};
+    std::atomic<uint64_t> written_position_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> writes_{0};    // batches written to stdout
+    std::atomic<bool> stop_{false};
+    std::once_flag started_;
+    std::thread thread_;
+    
+    // Drains until asked to stop, then drains what is left
+    void run() {
+        uint64_t read_position = 0;
+        char line[256];
+        while (true) {
+            bool stopping = stop_.load();
+            bool wrote = false;
+            
+            Record* slot = &slots_[read_position % RING_SIZE];
+            while (slot->sequence.load(std::memory_order_acquire) == read_position + 1) {
+                int length = format(*slot, line, sizeof(line));
+                std::fwrite(line, 1, length, stdout);
+                slot->sequence.store(read_position + RING_SIZE, std::memory_order_release);
+                read_position++;
+                wrote = true;
+                slot = &slots_[read_position % RING_SIZE];
+            }
+            
+            uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+            if (dropped > 0) {
+                std::fprintf(stdout, "  [LOG] %llu record(s) dropped\n", static_cast<unsigned long long>(dropped));
+                wrote = true;
+            }
+            
+            if (wrote) {
+                std::fflush(stdout);
+                writes_.fetch_add(1, std::memory_order_release);
+                written_position_.store(read_position, std::memory_order_release);
+            } else if (stopping) {
+                return;
+            } else {
+                written_position_.store(read_position, std::memory_order_release);
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+    
+    static const char* weaponName(int weapon) {
+        switch (weapon) {
+            case 0: return "flamethrower";
+            case 1: return "railgun";
+            case 2: return "grenade";
+            case 3: return "hammer";
+        }
+        return "unknown";
+    }
+    
+    static int format(const Record& record, char* line, size_t size) {
+        const int32_t* a = record.args;
+        int length = 0;
+        switch (record.event) {
+            case LogEvent::ArenaInit:
+                length = std::snprintf(line, size, "Initializing Arena %dx%d (seed %llu)\n", a[0], a[1],
+                                       (unsigned long long)(uint32_t(a[2])) << 32 | uint32_t(a[3])); break;
+            case LogEvent::ArenaCleanup:
+                length = std::snprintf(line, size, "Cleaning up Arena...\n"); break;
+            case LogEvent::ObstaclesPlaced:
+                length = std::snprintf(line, size, "Generating obstacles: %d mounds, %d pits, %d flamethrowers\n",
+                                       a[0], a[1], a[2]); break;
+            case LogEvent::RobotPlaced:
+                length = std::snprintf(line, size, "Placed robot %d at (%d, %d) with character '%c'\n",
+                                       a[0], a[1], a[2], a[3]); break;
+            case LogEvent::TurnStart:
+                length = std::snprintf(line, size, "\n  Processing turn for robot %d\n", a[0]); break;
+            case LogEvent::MoveRequest:
+                length = std::snprintf(line, size, "  [MOVE] Robot %d moving dir %d dist %d\n", a[0], a[1], a[2]); break;
+            case LogEvent::MoveInPit:
+                length = std::snprintf(line, size, "  [MOVE] Robot %d in pit, cannot move\n", a[0]); break;
+            case LogEvent::FlameStanding:
+                length = std::snprintf(line, size, "  [MOVE] Robot %d ended its turn on a flamethrower, takes %d damage!\n",
+                                       a[0], a[1]); break;
+            case LogEvent::FlameDamage:
+                length = std::snprintf(line, size, "  [MOVE] Robot %d takes %d flamethrower damage!\n", a[0], a[1]); break;
+            case LogEvent::Moved:
+                length = std::snprintf(line, size, "  [MOVE] Robot %d moved to (%d,%d)%s\n", a[0], a[1], a[2],
+                                       a[3] ? " (on flamethrower)" : ""); break;
+            case LogEvent::ShotFired:
+                length = std::snprintf(line, size, "  [SHOT] Robot %d fires %s at (%d, %d)\n", a[0], weaponName(a[1]),
+                                       a[2], a[3]); break;
+            case LogEvent::ShotAtSelf:
+                length = std::snprintf(line, size, "  [SHOT] Robot %d cannot target its own cell\n", a[0]); break;
+            case LogEvent::OutOfGrenades:
+                length = std::snprintf(line, size, "  [SHOT] Robot %d is out of grenades\n", a[0]); break;
+            case LogEvent::ShotMissed:
+                length = std::snprintf(line, size, "  [SHOT] Robot %d missed\n", a[0]); break;
+            case LogEvent::Hit:
+                length = std::snprintf(line, size, "  [HIT] Robot %d takes %d damage%s\n", a[0], a[1],
+                                       a[2] ? " and is destroyed!" : ""); break;
+            case LogEvent::SpectatorJoined:
+                length = std::snprintf(line, size, "[SPECTATE] Spectator connected (%d watching)\n", a[0]); break;
+            case LogEvent::SpectatorDropped:
+                length = std::snprintf(line, size, "[SPECTATE] Spectator disconnected or too slow (%d watching)\n",
+                                       a[0]); break;
+        }
+        if (length < 0) return 0;
+        return (length < static_cast<int>(size)) ? length : static_cast<int>(size) - 1;
+    }
+};
+
+LogRing& ring() {
+    static LogRing instance;
+    return instance;
+}
+
+std::atomic<LogLevel> current_level{LogLevel::Info};
+
+}
+
+namespace Logger {
+
+void setLevel(LogLevel level) {current_level.store(level, std::memory_order_relaxed);}
+LogLevel getLevel() {return current_level.load(std::memory_order_relaxed);}
+
+bool enabled(LogLevel level) {
+    return level >= current_level.load(std::memory_order_relaxed);
+}
+
+void write(LogLevel level, LogEvent event, const int32_t* args, int count) {
+    ring().push(level, event, args, count);
+}
+
+void flush() {ring().flush();}
+
+uint64_t outputCount() {return ring().outputCount();}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+// Engine logging. Producers on the hot path push small binary records into a
+// lock-free ring; a background thread formats and writes them. Records below
+// ROBOTWARZ_LOG_LEVEL are compiled out entirely, records below the runtime
+// level cost one relaxed load. When the ring is full records are dropped
+// (and counted) rather than stalling the simulation.
+
+enum class LogLevel { Debug, Info, Warning, Error, Off };
+
+// Compile-time floor (0 = Debug ... 4 = Off), e.g. -DROBOTWARZ_LOG_LEVEL=2
+#ifndef ROBOTWARZ_LOG_LEVEL
+#define ROBOTWARZ_LOG_LEVEL 0
+#endif
+
+// Every message the engine can log; Logger.cpp knows how to format each one
+enum class LogEvent : uint16_t {
+    ArenaInit,          // rows, cols, seed high word, seed low word
+    ArenaCleanup,
+    ObstaclesPlaced,    // mounds, pits, flamethrowers
+    RobotPlaced,        // robot, row, col, character
+    TurnStart,          // robot
+    MoveRequest,        // robot, direction, distance
+    MoveInPit,          // robot
+    FlameStanding,      // robot, damage
+    FlameDamage,        // robot, damage
+    Moved,              // robot, row, col, on_flamethrower
+    ShotFired,          // robot, weapon, row, col
+    ShotAtSelf,         // robot
+    OutOfGrenades,      // robot
+    ShotMissed,         // robot
+    Hit,                // robot, damage, destroyed
+    SpectatorJoined,    // clients
+    SpectatorDropped,   // clients
+};
+
+namespace Logger {
+
+constexpr int MAX_ARGS = 4;
+
+void setLevel(LogLevel level);
+LogLevel getLevel();
+bool enabled(LogLevel level);
+
+void write(LogLevel level, LogEvent event, const int32_t* args, int count);
+
+// Blocks until everything logged so far has been written out. Used at round
+// boundaries so log lines and frames stay in order on the terminal.
+void flush();
+
+// Goes up every time the log thread writes to stdout; the ANSI diff renderer
+// redraws the whole screen when it changed since the last frame.
+uint64_t outputCount();
+
+template <typename... Args>
+void log(LogLevel level, LogEvent event, Args... args) {
+    static_assert(sizeof...(Args) <= MAX_ARGS, "too many log arguments");
+    const int32_t values[MAX_ARGS + 1] = {static_cast<int32_t>(args)...};
+    write(level, event, values, sizeof...(Args));
+}
+
+}
+
+#define ROBOTWARZ_LOG(level, ...)                                                 \
+    do {                                                                          \
+        if constexpr (static_cast<int>(level) >= ROBOTWARZ_LOG_LEVEL) {           \
+            if (Logger::enabled(level)) Logger::log(level, __VA_ARGS__);          \
+        }                                                                         \
+    } while (0)
+
+#define LOG_DEBUG(...) ROBOTWARZ_LOG(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...) ROBOTWARZ_LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...) ROBOTWARZ_LOG(LogLevel::Warning, __VA_ARGS__)
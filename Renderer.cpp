@@ -0,0 +1,179 @@
+#include "Renderer.h"
+#include "Arena.h"
+#include "Logger.h"
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Screen layout in ANSI diff mode: title, column numbers, border, then the grid,
+// which starts after the row label and its '|'
+constexpr int GRID_FIRST_LINE = 4;
+
+}
+
+// Passes everything through to the terminal and counts it
+class Renderer::CountingBuffer : public std::streambuf {
+public:
+    explicit CountingBuffer(std::streambuf* target) : target_(target) {}
+    size_t count = 0;
+    
+protected:
+    int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+        count++;
+        return target_->sputc(traits_type::to_char_type(ch));
+    }
+    std::streamsize xsputn(const char* text, std::streamsize length) override {
+        count += length;
+        return target_->sputn(text, length);
+    }
+    int sync() override { return target_->pubsync(); }
+    
+private:
+    std::streambuf* target_;
+};
+
+Renderer::Renderer(int rows, int cols, bool ansi_diff)
+    : rows_(rows), cols_(cols), ansi_diff_(ansi_diff),
+      label_width_(std::max<int>(2, std::to_string(std::max(rows - 1, 0)).size())),
+      terminal_(nullptr), counting_(nullptr), output_seen_(0), log_output_seen_(0),
+      previous_cells_(rows * cols * 3, ' '), has_previous_(false) {
+    // Board is rows * (3 per cell + labels) plus headers; leave room for status lines
+    frame_.reserve((rows_ + 8) * (cols_ * 3 + 2 * label_width_ + 12) + 4096);
+    if (ansi_diff_) {
+        terminal_ = std::cout.rdbuf();
+        counting_ = new CountingBuffer(terminal_);
+        std::cout.rdbuf(counting_);
+    }
+}
+
+Renderer::~Renderer() {
+    if (counting_) {
+        std::cout.rdbuf(terminal_);
+        delete counting_;
+    }
+}
+
+void Renderer::appendInt(int value, int width) {
+    char digits[16];
+    int length = std::snprintf(digits, sizeof(digits), "%*d", width, value);
+    frame_.append(digits, length);
+}
+
+void Renderer::moveCursor(int line, int column) {
+    char sequence[32];
+    int length = std::snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", line, column);
+    frame_.append(sequence, length);
+}
+
+// Three display characters for a cell: " c " for terrain, "<c>" live robot,
+// "fcf" robot on a flamethrower, "xcx" dead robot
+void Renderer::appendCell(const Arena& arena, int row, int col, char* out) const {
+    char cell = arena.getCell(row, col);
+    int robot_id = arena.getRobotAt(row, col);
+    out[1] = cell;
+    if (robot_id < 0) {
+        out[0] = out[2] = ' ';
+        return;
+    }
+    if (!arena.isAlive(robot_id)) {
+        out[0] = out[2] = 'x';
+    } else if (arena.isOnFlamethrower(robot_id)) {
+        out[0] = out[2] = 'f';
+    } else {
+        out[0] = '<';
+        out[2] = '>';
+    }
+}
+
+void Renderer::appendColumnNumbers() {
+    frame_.append(label_width_, ' ');
+    for (int c = 0; c < cols_; ++c) {appendInt(c, 3);}
+    frame_.push_back('\n');
+}
+
+void Renderer::appendBorder() {
+    frame_.append(label_width_, ' ');
+    frame_.push_back('+');
+    frame_.append(cols_ * 3, '-');
+    frame_.append("+\n");
+}
+
+void Renderer::drawArena(const Arena& arena) {
+    char cell[3];
+    
+    // Something else (std::cout or the log thread) scrolled the terminal since the last frame
+    if (ansi_diff_) {
+        uint64_t log_output = Logger::outputCount();
+        if (counting_->count != output_seen_ || log_output != log_output_seen_) has_previous_ = false;
+        output_seen_ = counting_->count;
+        log_output_seen_ = log_output;
+    }
+    
+    if (ansi_diff_ && has_previous_) {
+        // Only redraw cells whose 3-character display changed
+        for (int r = 0; r < rows_; ++r) {
+            char* previous = &previous_cells_[r * cols_ * 3];
+            for (int c = 0; c < cols_; ++c, previous += 3) {
+                appendCell(arena, r, c, cell);
+                if (std::memcmp(cell, previous, 3) == 0) continue;
+                std::memcpy(previous, cell, 3);
+                moveCursor(GRID_FIRST_LINE + r, label_width_ + 2 + 3 * c);
+                frame_.append(cell, 3);
+            }
+        }
+        return;
+    }
+    
+    if (ansi_diff_) {
+        // First frame: clear the screen and draw from the top-left corner
+        frame_.append("\x1b[2J\x1b[H=== ARENA STATE ===\n");
+    } else {
+        frame_.append("\n=== ARENA STATE ===\n");
+    }
+    
+    appendColumnNumbers();
+    appendBorder();
+    
+    for (int r = 0; r < rows_; ++r) {
+        appendInt(r, label_width_);
+        frame_.push_back('|');
+        char* previous = &previous_cells_[r * cols_ * 3];
+        for (int c = 0; c < cols_; ++c, previous += 3) {
+            appendCell(arena, r, c, cell);
+            std::memcpy(previous, cell, 3);
+            frame_.append(cell, 3);
+        }
+        frame_.push_back('|');
+        appendInt(r);
+        frame_.push_back('\n');
+    }
+    
+    appendBorder();
+    appendColumnNumbers();
+    has_previous_ = true;
+}
+
+void Renderer::beginStatus() {
+    if (ansi_diff_) {
+        // Status block sits right under the board; clear it and everything below
+        moveCursor(GRID_FIRST_LINE + rows_ + 2, 1);
+        frame_.append("\x1b[J");
+    }
+}
+
+void Renderer::present() {
+    if (terminal_) {
+        // Straight to the terminal so the frame itself does not count as other output
+        std::cout.flush();
+        terminal_->sputn(frame_.data(), frame_.size());
+        terminal_->pubsync();
+    } else {
+        std::cout.write(frame_.data(), frame_.size());
+        std::cout.flush();
+    }
+    frame_.clear();
+}
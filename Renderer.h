@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+
+class Arena;
+
+// Composes a whole frame into one preallocated buffer and writes it out with a
+// single call. In ANSI diff mode only cells that changed since the previous
+// frame are sent (as cursor-move + redraw sequences), so terminal traffic
+// follows activity instead of arena area. Diffing assumes the screen still
+// shows the last frame, so anything else written to std::cout or by the log
+// thread in between makes the next frame a full redraw.
+class Renderer {
+private:
+    int rows_;
+    int cols_;
+    bool ansi_diff_;
+    int label_width_;      // digits in the widest row label, at least 2
+    
+    // Diff mode only: std::cout goes through a counting buffer, frames go
+    // straight to the terminal's own buffer
+    class CountingBuffer;
+    std::streambuf* terminal_;
+    CountingBuffer* counting_;
+    size_t output_seen_;      // count when the last frame was drawn
+    uint64_t log_output_seen_;  // Logger::outputCount() when the last frame was drawn
+    
+    std::string frame_;
+    
+    // What each cell showed last frame (3 characters per cell), for diffing
+    std::string previous_cells_;
+    bool has_previous_;
+    
+    void appendCell(const Arena& arena, int row, int col, char* out) const;
+    void appendColumnNumbers();
+    void appendBorder();
+    void moveCursor(int line, int column);
+    
+public:
+    Renderer(int rows, int cols, bool ansi_diff);
+    ~Renderer();
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+    
+    // Frame composition
+    void beginFrame() { frame_.clear(); }
+    void drawArena(const Arena& arena);
+    void beginStatus();
+    void append(const char* text, size_t length) { frame_.append(text, length); }
+    void append(const char* text) { frame_.append(text); }
+    void appendInt(int value, int width = 0);
+    
+    // Single write of the composed frame
+    void present();
+    
+    // Next frame redraws the whole screen
+    void invalidate() { has_previous_ = false; }
+    bool isAnsiDiff() const { return ansi_diff_; }
+    const std::string& getFrame() const { return frame_; }
+};
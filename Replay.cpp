@@ -0,0 +1,472 @@
+#include "Replay.h"
+#include "Arena.h"
+#include "Config.h"
+#include "Spectator.h"
+#include <iostream>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Replay;
+
+namespace {
+
+const char HEADER_MAGIC[8] = {'R', 'W', 'Z', 'R', 'E', 'P', 'L', 'Y'};
+const char TRAILER_MAGIC[8] = {'R', 'W', 'Z', 'I', 'N', 'D', 'E', 'X'};
+constexpr uint32_t FORMAT_VERSION = 1;
+
+// uint64 index offset, int32 last round, uint32 keyframe count, magic
+constexpr size_t TRAILER_SIZE = 8 + 4 + 4 + 8;
+
+}
+
+// ---------------------------------------------------------------- recorder
+
+ReplayRecorder::ReplayRecorder(const GameConfig& config, const Arena& arena)
+    : out_(config.replay_file, std::ios::binary | std::ios::trunc),
+      keyframe_interval_(config.replay_keyframe_interval > 0 ? config.replay_keyframe_interval : 1),
+      offset_(0), last_round_(0), finished_(false), spectators_(nullptr),
+      rows_(arena.getRows()), cols_(arena.getCols()) {
+    for (const auto& robot : arena.getRobots()) {robot_names_.emplace_back(robot->m_character, robot->m_name);}
+    
+    // Sized up front so recording a round never grows a buffer
+    buffer_.reserve(arena.getRows() * arena.getCols() + arena.getRobots().size() * 64 + 4096);
+    keyframe_offsets_.reserve(config.max_rounds / keyframe_interval_ + 2);
+    
+    if (config.replay_file.empty()) return;    // streaming only
+    if (!out_) {
+        std::cerr << "Replay: cannot open " << config.replay_file << " for writing" << std::endl;
+        return;
+    }
+    
+    // Initial state is the keyframe for round 0
+    encodeHeader(buffer_);
+    writeKeyframe(0, arena);
+    writeBuffer();
+}
+
+void ReplayRecorder::encodeHeader(std::vector<char>& out) const {
+    out.insert(out.end(), HEADER_MAGIC, HEADER_MAGIC + sizeof(HEADER_MAGIC));
+    put(out, FORMAT_VERSION);
+    put(out, int32_t(rows_));
+    put(out, int32_t(cols_));
+    put(out, int32_t(keyframe_interval_));
+    put(out, int32_t(robot_names_.size()));
+    for (const auto& [character, name] : robot_names_) {
+        put(out, character);
+        uint8_t length = name.size() > 255 ? 255 : name.size();
+        put(out, length);
+        out.insert(out.end(), name.data(), name.data() + length);
+    }
+}
+
+void ReplayRecorder::encodeStreamStart(std::vector<char>& out, int round, const Arena& arena) const {
+    encodeHeader(out);
+    encodeKeyframe(out, round, arena);
+}
+
+ReplayRecorder::~ReplayRecorder() {
+    finish();
+}
+
+void ReplayRecorder::writeBuffer() {
+    if (out_.is_open()) {
+        out_.write(buffer_.data(), buffer_.size());
+        offset_ += buffer_.size();
+    }
+    if (spectators_) spectators_->broadcast(buffer_.data(), buffer_.size());
+    buffer_.clear();
+}
+
+void ReplayRecorder::beginRound(int round) {
+    if (!isActive()) return;
+    put(uint8_t(ROUND));
+    put(int32_t(round));
+    last_round_ = round;
+}
+
+void ReplayRecorder::endRound(int round, const Arena& arena) {
+    if (!isActive()) return;
+    if (out_.is_open() && round % keyframe_interval_ == 0) {
+        writeKeyframe(round, arena);
+    }
+    writeBuffer();
+}
+
+void ReplayRecorder::writeKeyframe(int round, const Arena& arena) {
+    keyframe_offsets_.push_back(offset_ + buffer_.size());
+    encodeKeyframe(buffer_, round, arena);
+}
+
+void ReplayRecorder::encodeKeyframe(std::vector<char>& out, int round, const Arena& arena) const {
+    put(out, uint8_t(KEYFRAME));
+    put(out, int32_t(round));
+    for (int r = 0; r < arena.getRows(); r++) {
+        for (int c = 0; c < arena.getCols(); c++) {out.push_back(arena.getCell(r, c));}
+    }
+    for (int i = 0; i < arena.getRobotCount(); i++) {
+        RobotBase& robot = *arena.getRobots()[i];
+        put(out, int32_t(arena.getRobotRow(i)));
+        put(out, int32_t(arena.getRobotCol(i)));
+        put(out, int32_t(robot.get_health()));
+        put(out, int32_t(robot.get_armor()));
+        put(out, int32_t(robot.get_move_speed()));
+        put(out, int32_t(robot.get_grenades()));
+        put(out, uint8_t(arena.isOnFlamethrower(i)));
+    }
+}
+
+void ReplayRecorder::recordRadar(int robot_id, int direction) {
+    put(uint8_t(RADAR));
+    put(uint16_t(robot_id));
+    put(uint8_t(direction));
+}
+
+void ReplayRecorder::recordShot(int robot_id, int row, int col) {
+    put(uint8_t(SHOT));
+    put(uint16_t(robot_id));
+    put(int32_t(row));
+    put(int32_t(col));
+}
+
+void ReplayRecorder::recordMove(int robot_id, int from_row, int from_col, int to_row, int to_col,
+                                char restored, bool on_flamethrower) {
+    put(uint8_t(MOVE));
+    put(uint16_t(robot_id));
+    put(int32_t(from_row));
+    put(int32_t(from_col));
+    put(int32_t(to_row));
+    put(int32_t(to_col));
+    put(restored);
+    put(uint8_t(on_flamethrower));
+}
+
+void ReplayRecorder::recordDamage(int robot_id, int amount, int health, int armor) {
+    put(uint8_t(DAMAGE));
+    put(uint16_t(robot_id));
+    put(int32_t(amount));
+    put(int32_t(health));
+    put(int32_t(armor));
+}
+
+void ReplayRecorder::recordDeath(int robot_id) {
+    put(uint8_t(DEATH));
+    put(uint16_t(robot_id));
+}
+
+void ReplayRecorder::recordStats(int robot_id, RobotBase& robot) {
+    put(uint8_t(STATS));
+    put(uint16_t(robot_id));
+    put(int32_t(robot.get_health()));
+    put(int32_t(robot.get_armor()));
+    put(int32_t(robot.get_move_speed()));
+    put(int32_t(robot.get_grenades()));
+}
+
+void ReplayRecorder::finish() {
+    if (!isActive() || finished_) return;
+    finished_ = true;
+    
+    // Spectators get the END record but not the file's index
+    put(uint8_t(END));
+    if (spectators_) {
+        spectators_->broadcast(buffer_.data(), buffer_.size());
+        spectators_ = nullptr;
+    }
+    if (!out_.is_open()) {
+        buffer_.clear();
+        return;
+    }
+    uint64_t index_offset = offset_ + buffer_.size();
+    for (uint64_t offset : keyframe_offsets_) {put(offset);}
+    put(index_offset);
+    put(int32_t(last_round_));
+    put(uint32_t(keyframe_offsets_.size()));
+    buffer_.insert(buffer_.end(), TRAILER_MAGIC, TRAILER_MAGIC + sizeof(TRAILER_MAGIC));
+    writeBuffer();
+    out_.close();
+}
+
+// ---------------------------------------------------------------- player
+
+ReplayPlayer::ReplayPlayer()
+    : data_(nullptr), size_(0), fd_(-1), rows_(0), cols_(0), keyframe_interval_(1),
+      last_round_(0), records_end_(0), round_(-1), round_events_begin_(0), round_events_end_(0) {}
+
+ReplayPlayer::~ReplayPlayer() {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+    if (fd_ >= 0) close(fd_);
+}
+
+template <typename T>
+T ReplayPlayer::get(size_t& offset) const {
+    T value;
+    std::memcpy(&value, data_ + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+bool ReplayPlayer::open(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        std::cerr << "Replay: cannot open " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd_, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(HEADER_MAGIC) + TRAILER_SIZE)) {
+        std::cerr << "Replay: " << path << " is too short" << std::endl;
+        return false;
+    }
+    size_ = info.st_size;
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Replay: cannot map " << path << std::endl;
+        return false;
+    }
+    data_ = static_cast<const char*>(mapped);
+    
+    if (std::memcmp(data_, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0 ||
+        std::memcmp(data_ + size_ - sizeof(TRAILER_MAGIC), TRAILER_MAGIC, sizeof(TRAILER_MAGIC)) != 0) {
+        std::cerr << "Replay: " << path << " is not a complete RobotWarz replay" << std::endl;
+        return false;
+    }
+    
+    auto corrupt = [&path](const char* what) {
+        std::cerr << "Replay: " << path << " is corrupt (" << what << ")" << std::endl;
+        return false;
+    };
+    size_t trailer = size_ - TRAILER_SIZE;
+    size_t offset = sizeof(HEADER_MAGIC);
+    if (!fits(offset, 5 * 4, trailer)) return corrupt("header");
+    if (get<uint32_t>(offset) != FORMAT_VERSION) {
+        std::cerr << "Replay: unsupported format version" << std::endl;
+        return false;
+    }
+    rows_ = get<int32_t>(offset);
+    cols_ = get<int32_t>(offset);
+    keyframe_interval_ = get<int32_t>(offset);
+    int robot_count = get<int32_t>(offset);
+    // Robot ids are recorded as uint16, and every keyframe holds the whole grid
+    if (rows_ <= 0 || cols_ <= 0 || uint64_t(rows_) * uint64_t(cols_) > size_) return corrupt("arena size");
+    if (keyframe_interval_ <= 0) return corrupt("keyframe interval");
+    if (robot_count < 0 || robot_count > 65536) return corrupt("robot count");
+    for (int i = 0; i < robot_count; i++) {
+        if (!fits(offset, 2, trailer)) return corrupt("robot names");
+        characters_.push_back(get<char>(offset));
+        uint8_t length = get<uint8_t>(offset);
+        if (!fits(offset, length, trailer)) return corrupt("robot names");
+        names_.emplace_back(data_ + offset, length);
+        offset += length;
+    }
+    grid_.assign(size_t(rows_) * cols_, '.');
+    robots_.resize(robot_count);
+    size_t header_end = offset;
+    
+    // Trailer -> keyframe index, which must sit between the records and the trailer
+    uint64_t index_offset = get<uint64_t>(trailer);
+    last_round_ = get<int32_t>(trailer);
+    uint32_t keyframe_count = get<uint32_t>(trailer);
+    trailer = size_ - TRAILER_SIZE;
+    if (last_round_ < 0) return corrupt("last round");
+    if (index_offset < header_end || !fits(index_offset, uint64_t(keyframe_count) * 8, trailer)) {
+        return corrupt("keyframe index");
+    }
+    records_end_ = index_offset;
+    
+    size_t index = index_offset;
+    for (uint32_t i = 0; i < keyframe_count; i++) {
+        uint64_t keyframe = get<uint64_t>(index);
+        if (keyframe < header_end || !fits(keyframe, 1 + payloadSize(KEYFRAME), records_end_) ||
+            uint8_t(data_[keyframe]) != KEYFRAME) {
+            return corrupt("keyframe offset");
+        }
+        keyframe_offsets_.push_back(keyframe);
+    }
+    if (keyframe_offsets_.empty()) return corrupt("no keyframes");
+    return true;
+}
+
+size_t ReplayPlayer::payloadSize(uint8_t type) const {
+    switch (type) {
+        case ROUND:    return 4;
+        case KEYFRAME: return 4 + grid_.size() + robots_.size() * (6 * 4 + 1);
+        case RADAR:    return 2 + 1;
+        case SHOT:     return 2 + 2 * 4;
+        case MOVE:     return 2 + 4 * 4 + 2;
+        case DAMAGE:   return 2 + 3 * 4;
+        case DEATH:    return 2;
+        case STATS:    return 2 + 4 * 4;
+        case END:      return 0;
+        default:       return 0;
+    }
+}
+
+size_t ReplayPlayer::readKeyframe(size_t offset) {
+    // open() checked that every indexed keyframe fits
+    offset += 1;  // record type
+    round_ = get<int32_t>(offset);
+    std::memcpy(grid_.data(), data_ + offset, grid_.size());
+    offset += grid_.size();
+    for (auto& robot : robots_) {
+        robot.row = get<int32_t>(offset);
+        robot.col = get<int32_t>(offset);
+        robot.health = get<int32_t>(offset);
+        robot.armor = get<int32_t>(offset);
+        robot.move = get<int32_t>(offset);
+        robot.grenades = get<int32_t>(offset);
+        robot.on_flamethrower = get<uint8_t>(offset);
+    }
+    return offset;
+}
+
+bool ReplayPlayer::seek(int round) {
+    if (!data_ || keyframe_offsets_.empty()) return false;
+    if (round < 0) round = 0;
+    if (round > last_round_) round = last_round_;
+    
+    // Start from the keyframe strictly before the round (so its events get
+    // walked too), keyframes sit at multiples of the interval
+    size_t keyframe = (round == 0) ? 0 : (round - 1) / keyframe_interval_;
+    if (keyframe >= keyframe_offsets_.size()) keyframe = keyframe_offsets_.size() - 1;
+    size_t offset = readKeyframe(keyframe_offsets_[keyframe]);
+    round_events_begin_ = round_events_end_ = offset;
+    
+    auto corrupt = [](size_t at) {
+        std::cerr << "Replay: corrupt record at offset " << at << std::endl;
+        return false;
+    };
+    while (offset < records_end_) {
+        size_t record_start = offset;
+        uint8_t type = get<uint8_t>(offset);
+        if (type == END) break;
+        size_t payload = payloadSize(type);
+        if (payload == 0 || !fits(offset, payload, records_end_)) return corrupt(record_start);
+        if (type == ROUND) {
+            int next_round = get<int32_t>(offset);
+            if (next_round > round) {offset = record_start; break;}
+            round_ = next_round;
+            round_events_begin_ = offset;
+            continue;
+        }
+        if (type == KEYFRAME) {
+            // State it holds is what we have already rebuilt; skip over it
+            offset += payload;
+            continue;
+        }
+        
+        size_t robot_id = get<uint16_t>(offset);
+        if (robot_id >= robots_.size()) return corrupt(record_start);
+        RobotState& robot = robots_[robot_id];
+        switch (type) {
+            case RADAR: offset += 1; break;
+            case SHOT:  offset += 8; break;
+            case MOVE: {
+                int from_row = get<int32_t>(offset);
+                int from_col = get<int32_t>(offset);
+                int to_row = get<int32_t>(offset);
+                int to_col = get<int32_t>(offset);
+                if (!inGrid(from_row, from_col) || !inGrid(to_row, to_col)) return corrupt(record_start);
+                robot.row = to_row;
+                robot.col = to_col;
+                grid_[from_row * cols_ + from_col] = get<char>(offset);
+                grid_[robot.row * cols_ + robot.col] = characters_[robot_id];
+                robot.on_flamethrower = get<uint8_t>(offset);
+                break;
+            }
+            case DAMAGE:
+                offset += 4;
+                robot.health = get<int32_t>(offset);
+                robot.armor = get<int32_t>(offset);
+                break;
+            case DEATH:
+                robot.health = 0;
+                break;
+            case STATS:
+                robot.health = get<int32_t>(offset);
+                robot.armor = get<int32_t>(offset);
+                robot.move = get<int32_t>(offset);
+                robot.grenades = get<int32_t>(offset);
+                break;
+        }
+    }
+    round_events_end_ = offset;
+    if (round_ != round) round_events_begin_ = round_events_end_;
+    return true;
+}
+
+void ReplayPlayer::print() const {
+    std::cout << "\n=== REPLAY: STATE AFTER ROUND " << round_ << " / " << last_round_ << " ===\n";
+    for (int r = 0; r < rows_; r++) {
+        std::cout << (r < 10 ? " " : "") << r << "|";
+        for (int c = 0; c < cols_; c++) {
+            char cell = grid_[r * cols_ + c];
+            const char* sides = "  ";
+            for (size_t i = 0; i < robots_.size(); i++) {
+                if (robots_[i].row == r && robots_[i].col == c && characters_[i] == cell) {
+                    sides = (robots_[i].health <= 0) ? "xx" : robots_[i].on_flamethrower ? "ff" : "<>";
+                    break;
+                }
+            }
+            std::cout << sides[0] << cell << sides[1];
+        }
+        std::cout << "|\n";
+    }
+    
+    std::cout << "\nEvents in round " << round_ << ":\n";
+    size_t offset = round_events_begin_;
+    while (offset < round_events_end_) {
+        uint8_t type = get<uint8_t>(offset);
+        if (type == KEYFRAME || type == ROUND || type == END) break;
+        size_t robot_id = get<uint16_t>(offset);
+        if (robot_id >= names_.size()) break;
+        std::cout << "  Robot " << robot_id << " (" << names_[robot_id] << "): ";
+        switch (type) {
+            case RADAR:
+                std::cout << "radar " << int(get<uint8_t>(offset));
+                break;
+            case SHOT: {
+                int row = get<int32_t>(offset);
+                int col = get<int32_t>(offset);
+                std::cout << "shoots at (" << row << "," << col << ")";
+                break;
+            }
+            case MOVE: {
+                offset += 8;
+                int row = get<int32_t>(offset);
+                int col = get<int32_t>(offset);
+                offset += 2;
+                std::cout << "moves to (" << row << "," << col << ")";
+                break;
+            }
+            case DAMAGE: {
+                int amount = get<int32_t>(offset);
+                int health = get<int32_t>(offset);
+                offset += 4;
+                std::cout << "takes " << amount << " damage, health " << health;
+                break;
+            }
+            case DEATH:
+                std::cout << "destroyed";
+                break;
+            case STATS:
+                offset += 16;
+                std::cout << "stats changed";
+                break;
+        }
+        std::cout << "\n";
+    }
+    
+    std::cout << "\nRobots:\n";
+    for (size_t i = 0; i < robots_.size(); i++) {
+        const RobotState& robot = robots_[i];
+        std::cout << "  Robot " << i << ": " << names_[i] << " '" << characters_[i] << "'"
+                  << " | H:" << robot.health << " A:" << robot.armor << " M:" << robot.move;
+        if (robot.grenades > 0) std::cout << " G:" << robot.grenades;
+        std::cout << " @(" << robot.row << "," << robot.col << ")";
+        if (robot.health <= 0) std::cout << " [DEAD]";
+        std::cout << "\n";
+    }
+    std::cout << std::endl;
+}
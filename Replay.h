@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Arena;
+class RobotBase;
+class SpectatorServer;
+struct GameConfig;
+
+// Compact binary match recording.
+//
+// Layout: header (arena size, robots), then a stream of records: a ROUND
+// marker opens each round and is followed by that round's events; a KEYFRAME
+// (full grid + robot stats) is written after round 0 and every
+// keyframe_interval rounds. The file ends with an index of keyframe offsets
+// and a fixed-size trailer pointing at it, so a player can jump to any round
+// through the nearest keyframe and only replay the deltas after it.
+namespace Replay {
+
+enum RecordType : uint8_t {
+    ROUND = 1,      // int32 round
+    KEYFRAME,       // int32 round, grid, robot states
+    RADAR,          // uint16 robot, uint8 direction
+    SHOT,           // uint16 robot, int32 row, col
+    MOVE,           // uint16 robot, int32 from_row, from_col, to_row, to_col, char restored, uint8 on_flamethrower
+    DAMAGE,         // uint16 robot, int32 amount, health, armor
+    DEATH,          // uint16 robot
+    STATS,          // uint16 robot, int32 health, armor, move, grenades
+    END             // no payload, index follows
+};
+
+struct RobotState {
+    int32_t row;
+    int32_t col;
+    int32_t health;
+    int32_t armor;
+    int32_t move;
+    int32_t grenades;
+    uint8_t on_flamethrower;
+};
+
+}
+
+class ReplayRecorder {
+private:
+    std::ofstream out_;
+    int keyframe_interval_;
+    uint64_t offset_;
+    
+    // Current round's bytes, written to the file once per round
+    std::vector<char> buffer_;
+    std::vector<uint64_t> keyframe_offsets_;
+    int last_round_;
+    bool finished_;
+    
+    // Live stream of every round (not owned)
+    SpectatorServer* spectators_;
+    
+    // Header fields for a stream start
+    int rows_;
+    int cols_;
+    std::vector<std::pair<char, std::string>> robot_names_;
+    
+    template <typename T>
+    static void put(std::vector<char>& out, const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+    template <typename T>
+    void put(const T& value) { put(buffer_, value); }
+    void encodeHeader(std::vector<char>& out) const;
+    void encodeKeyframe(std::vector<char>& out, int round, const Arena& arena) const;
+    void writeBuffer();
+    
+public:
+    // Records to config.replay_file (if set) every config.replay_keyframe_interval rounds
+    ReplayRecorder(const GameConfig& config, const Arena& arena);
+    ~ReplayRecorder();
+    
+    bool isOpen() const { return out_.is_open(); }
+    // Recording to a file, streaming to spectators, or both
+    bool isActive() const { return out_.is_open() || spectators_; }
+    
+    // Every finished round's records also go to these spectators
+    void setSpectators(SpectatorServer* spectators) { spectators_ = spectators; }
+    // Header plus a keyframe of the arena after 'round': where a live stream begins
+    void encodeStreamStart(std::vector<char>& out, int round, const Arena& arena) const;
+    
+    // Round framing: keyframes are taken at the end of every keyframe_interval-th round
+    void beginRound(int round);
+    void endRound(int round, const Arena& arena);
+    void writeKeyframe(int round, const Arena& arena);
+    
+    // Events
+    void recordRadar(int robot_id, int direction);
+    void recordShot(int robot_id, int row, int col);
+    void recordMove(int robot_id, int from_row, int from_col, int to_row, int to_col, char restored, bool on_flamethrower);
+    void recordDamage(int robot_id, int amount, int health, int armor);
+    void recordDeath(int robot_id);
+    void recordStats(int robot_id, RobotBase& robot);
+    
+    // Writes the keyframe index and trailer; called by the destructor if needed
+    void finish();
+};
+
+class ReplayPlayer {
+private:
+    const char* data_;
+    size_t size_;
+    int fd_;
+    
+    int rows_;
+    int cols_;
+    int keyframe_interval_;
+    std::vector<std::string> names_;
+    std::vector<char> characters_;
+    std::vector<uint64_t> keyframe_offsets_;
+    int last_round_;
+    
+    // Records run from the end of the header up to the keyframe index
+    size_t records_end_;
+    
+    // State after the round last sought to
+    int round_;
+    std::vector<char> grid_;
+    std::vector<Replay::RobotState> robots_;
+    
+    // Events of round_ (offset range inside the file) for printing
+    size_t round_events_begin_;
+    size_t round_events_end_;
+    
+    // get() does no checking: callers make sure the bytes are there first
+    template <typename T>
+    T get(size_t& offset) const;
+    bool fits(size_t offset, size_t bytes, size_t end) const { return offset <= end && bytes <= end - offset; }
+    // Bytes after the type byte of a record, 0 for an unknown type
+    size_t payloadSize(uint8_t type) const;
+    bool inGrid(int row, int col) const { return row >= 0 && row < rows_ && col >= 0 && col < cols_; }
+    size_t readKeyframe(size_t offset);
+    
+public:
+    ReplayPlayer();
+    ~ReplayPlayer();
+    
+    // Maps the file and reads the header and keyframe index. Every size and offset
+    // is checked against the file, so a truncated or corrupt file fails here (or
+    // in seek) instead of being read past its end.
+    bool open(const std::string& path);
+    
+    // Rebuilds the state after 'round' from the nearest keyframe at or before it
+    bool seek(int round);
+    
+    int getRound() const { return round_; }
+    int getLastRound() const { return last_round_; }
+    int getRows() const { return rows_; }
+    int getCols() const { return cols_; }
+    char getCell(int row, int col) const { return grid_[row * cols_ + col]; }
+    const std::vector<Replay::RobotState>& getRobotStates() const { return robots_; }
+    
+    void print() const;
+};
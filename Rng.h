@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <random>
+
+// xoshiro256** generator. Small, fast and fully determined by its seed, so every
+// Arena/EventHandler can own one: a seed reproduces a match exactly, and matches
+// running on different threads share no hidden state.
+class Rng {
+private:
+    uint64_t state_[4];
+    
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    
+    // splitmix64, used to expand one seed into the full state
+    static uint64_t splitmix(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    
+public:
+    // Different streams of the same seed give unrelated sequences
+    explicit Rng(uint64_t seed, uint64_t stream = 0) {
+        uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+        for (auto& word : state_) word = splitmix(x);
+    }
+    
+    uint64_t next() {
+        const uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        const uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+    
+    // Uniform in [0, n) without modulo bias (Lemire's multiply-and-reject)
+    uint32_t below(uint32_t n) {
+        uint64_t m = (next() >> 32) * n;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < n) {
+            const uint32_t threshold = -n % n;
+            while (low < threshold) {
+                m = (next() >> 32) * n;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+    
+    // Uniform in [low, high]
+    int range(int low, int high) { return low + static_cast<int>(below(high - low + 1)); }
+    
+    // Non-zero seed for when the config asks for a random match
+    static uint64_t randomSeed() {
+        uint64_t x = (uint64_t(std::random_device{}()) << 32) ^ std::random_device{}() ^
+                     static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        uint64_t seed = splitmix(x);
+        return seed ? seed : 1;
+    }
+};
@@ -0,0 +1,183 @@
+#include "RobotBuilder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 64-bit FNV-1a, continued from 'hash'
+uint64_t fnv1a(uint64_t hash, const std::string& data) {
+    for (unsigned char byte : data) {
+        hash ^= byte;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ULL;
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+std::string hexHash(uint64_t hash) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+    return text;
+}
+
+}
+
+RobotBuilder::RobotBuilder(const GameConfig& config)
+    : source_dir_(config.robot_directory),
+      cache_dir_(config.robot_cache_directory),
+      pch_dir_(config.robot_cache_directory + "/pch"),
+      base_object_(config.robot_base_object),
+      compile_command_(config.robot_compiler + " " + config.robot_compile_flags + " -I" + config.robot_directory),
+      common_hash_(0), pch_ready_(false) {}
+
+std::vector<std::string> RobotBuilder::findSources() const {
+    std::vector<std::string> sources;
+    try {
+        for (const auto& entry : fs::directory_iterator(source_dir_)) {
+            std::string name = entry.path().filename().string();
+            if (entry.is_regular_file() && name.rfind("Robot_", 0) == 0 && entry.path().extension() == ".cpp") {
+                sources.push_back(entry.path().string());
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Directory error: " << e.what() << std::endl;
+    }
+    std::sort(sources.begin(), sources.end());
+    return sources;
+}
+
+bool RobotBuilder::refresh() {
+    std::error_code error;
+    fs::create_directories(pch_dir_, error);
+    
+    uint64_t hash = fnv1a(FNV_OFFSET, compile_command_);
+    for (const std::string& input : {source_dir_ + "/RobotBase.h", source_dir_ + "/RadarObj.h", base_object_}) {
+        std::string contents;
+        if (!readFile(input, contents)) {
+            std::cerr << "  ERROR: cannot read " << input << std::endl;
+            return false;
+        }
+        hash = fnv1a(hash, contents);
+    }
+    // Toolkit headers ship with the engine but most robots never include them;
+    // a missing one hashes as empty (a robot that needs it fails to compile)
+    for (const char* toolkit : {"/RobotToolkit.h", "/FlowField.h"}) {
+        std::string contents;
+        if (!readFile(source_dir_ + toolkit, contents)) contents.clear();
+        hash = fnv1a(fnv1a(hash, toolkit), contents);
+    }
+    if (hash == common_hash_) return true;
+    common_hash_ = hash;
+    
+    // A RobotBase.h.gch next to the header would also be picked up by anything
+    // else built with -I on that directory (the engine itself, with the default
+    // "."), so remove any left by older versions of the builder
+    fs::remove(source_dir_ + "/RobotBase.h.gch", error);
+    
+    // The precompiled header lives in the cache and is force-included into robot
+    // compiles only. GCC does not notice a stale .gch by itself, hence the stamp.
+    std::string header = source_dir_ + "/RobotBase.h";
+    std::string pch = pch_dir_ + "/RobotBase.h.gch";
+    std::string stamp_path = pch_dir_ + "/RobotBase.h.gch.hash";
+    std::string stamp;
+    if (readFile(stamp_path, stamp) && stamp == hexHash(hash) && fs::exists(pch)) {
+        pch_ready_ = true;
+        return true;
+    }
+    fs::remove(stamp_path, error);
+    std::string command = compile_command_ + " -x c++-header " + header + " -o " + pch +
+                          " > " + pch_dir_ + "/RobotBase.h.log 2>&1";
+    pch_ready_ = std::system(command.c_str()) == 0;
+    if (pch_ready_) {
+        std::ofstream(stamp_path) << hexHash(hash);
+    } else {
+        // Robots still build without it, just slower
+        std::cerr << "  WARNING: precompiled header failed, see " << pch_dir_ << "/RobotBase.h.log" << std::endl;
+        fs::remove(pch, error);
+    }
+    return true;
+}
+
+RobotBuild RobotBuilder::compile(const std::string& source) const {
+    RobotBuild result = {source, "", false, false};
+    
+    std::string contents;
+    if (!readFile(source, contents)) {
+        std::cerr << "  ERROR: cannot read " << source << std::endl;
+        return result;
+    }
+    std::string stem = fs::path(source).stem().string();
+    result.library = cache_dir_ + "/" + stem + "-" + hexHash(fnv1a(common_hash_, contents)) + ".so";
+    
+    if (fs::exists(result.library)) {
+        result.cached = result.ok = true;
+        return result;
+    }
+    
+    // Build under a temporary name so a crash or a concurrent loader never sees half a library
+    std::string temporary = result.library + ".tmp";
+    std::string log = cache_dir_ + "/" + stem + ".log";
+    // -include of the cache copy's path finds RobotBase.h.gch beside it; the
+    // robot's own #include "RobotBase.h" is then skipped by its #pragma once
+    std::string precompiled = pch_ready_ ? " -include " + pch_dir_ + "/RobotBase.h" : "";
+    std::string command = compile_command_ + precompiled + " -shared -o " + temporary + " " + source + " " +
+                          base_object_ + " > " + log + " 2>&1";
+    if (std::system(command.c_str()) != 0) {
+        std::string errors;
+        readFile(log, errors);
+        std::cerr << "  ERROR: failed to compile " << source << ":\n" << errors << std::flush;
+        return result;
+    }
+    
+    std::error_code error;
+    fs::rename(temporary, result.library, error);
+    if (error) {
+        std::cerr << "  ERROR: " << error.message() << std::endl;
+        return result;
+    }
+    
+    // Older builds of this robot are dead weight now
+    for (const auto& entry : fs::directory_iterator(cache_dir_, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind(stem + "-", 0) == 0 && name.size() == stem.size() + 20 &&
+            entry.path().extension() == ".so" && entry.path().string() != result.library) {
+            fs::remove(entry.path(), error);
+        }
+    }
+    result.ok = true;
+    return result;
+}
+
+std::vector<RobotBuild> RobotBuilder::buildAll(ThreadPool& pool) {
+    std::vector<std::string> sources = findSources();
+    std::vector<RobotBuild> results(sources.size());
+    if (!refresh()) return results;
+    
+    for (size_t i = 0; i < sources.size(); i++) {
+        pool.submit([this, &sources, &results, i] { results[i] = compile(sources[i]); });
+    }
+    pool.wait();
+    return results;
+}
+
+RobotBuild RobotBuilder::build(const std::string& source) {
+    if (!refresh()) return {source, "", false, false};
+    return compile(source);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Config.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct RobotBuild {
+    std::string source;     // Robot_*.cpp
+    std::string library;    // cached .so, named after the content hash
+    bool cached;            // up to date already, nothing was compiled
+    bool ok;
+};
+
+// Compiles Robot_*.cpp into shared objects the way the spec describes
+// (g++ -shared ... RobotBase.o), but keyed on content: a robot is only rebuilt
+// when its source, RobotBase.h/RadarObj.h, the toolkit headers (RobotToolkit.h,
+// FlowField.h; optional), RobotBase.o or the flags change. Nothing is written to
+// the source directory: the precompiled header lives in the cache too.
+// Libraries live in the cache directory as <stem>-<hash>.so, so a rebuilt robot
+// always gets a new path and can be dlopened next to the old one.
+class RobotBuilder {
+private:
+    std::string source_dir_;
+    std::string cache_dir_;
+    std::string pch_dir_;       // precompiled RobotBase.h, used by robot compiles only
+    std::string base_object_;
+    std::string compile_command_;
+    
+    // Hash of everything every robot depends on besides its own source
+    uint64_t common_hash_;
+    bool pch_ready_;
+    
+    // Re-hashes the shared inputs and rebuilds the RobotBase.h precompiled header if they changed
+    bool refresh();
+    RobotBuild compile(const std::string& source) const;
+    
+public:
+    explicit RobotBuilder(const GameConfig& config);
+    
+    // Robot_*.cpp in the source directory, sorted by name
+    std::vector<std::string> findSources() const;
+    
+    // Builds every robot in parallel; results come back in findSources() order
+    std::vector<RobotBuild> buildAll(ThreadPool& pool);
+    
+    // Builds a single robot on the calling thread
+    RobotBuild build(const std::string& source);
+};
@@ -0,0 +1,88 @@
+#include "RobotLoader.h"
+#include "IsolatedRobot.h"
+#include <iostream>
+#include <filesystem>
+#include <dlfcn.h>
+
+namespace fs = std::filesystem;
+
+RobotLoader::~RobotLoader() {
+    for (auto& library : libraries_) {
+        dlclose(library.handle);
+    }
+}
+
+int RobotLoader::loadDirectory(const std::string& directory) {
+    int loaded = 0;
+    try {
+        for (const auto& entry : fs::directory_iterator(directory)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".so") {
+                if (loadLibrary(entry.path().string())) loaded++;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Directory error: " << e.what() << std::endl;
+    }
+    return loaded;
+}
+
+bool RobotLoader::loadLibrary(const std::string& path) {
+    RobotLibrary library;
+    if (!openLibrary(path, library)) return false;
+    libraries_.push_back(library);
+    return true;
+}
+
+bool RobotLoader::reloadLibrary(int index, const std::string& path) {
+    RobotLibrary library;
+    if (!openLibrary(path, library)) return false;
+    dlclose(libraries_[index].handle);
+    libraries_[index] = library;
+    return true;
+}
+
+bool RobotLoader::openLibrary(const std::string& path, RobotLibrary& library) {
+    std::cout << "Loading: " << path << std::endl;
+    
+    void* handle = dlopen(path.c_str(), RTLD_LAZY);
+    if (!handle) {
+        std::cerr << "  ERROR: " << dlerror() << std::endl;
+        return false;
+    }
+    
+    dlerror(); // Clear errors
+    RobotFactory create_robot = (RobotFactory)dlsym(handle, "create_robot");
+    
+    if (dlerror()) {
+        std::cerr << "  ERROR: No create_robot() function" << std::endl;
+        dlclose(handle);
+        return false;
+    }
+    
+    // Build one instance to check the factory works and learn the robot's name
+    RobotBase* sample = create_robot();
+    if (!sample) {
+        std::cerr << "  ERROR: create_robot() returned null" << std::endl;
+        dlclose(handle);
+        return false;
+    }
+    
+    library.path = path;
+    library.name = sample->m_name;
+    library.handle = handle;
+    library.create = create_robot;
+    delete sample;
+    
+    std::cout << "  SUCCESS: Loaded " << library.name << std::endl;
+    return true;
+}
+
+std::shared_ptr<RobotBase> RobotLoader::create(int index) const {
+    RobotBase* robot = libraries_[index].create();
+    return std::shared_ptr<RobotBase>(robot);
+}
+
+std::shared_ptr<RobotBase> RobotLoader::create(int index, const GameConfig& config) const {
+    if (!config.isolate_robots) return create(index);
+    return IsolatedRobot::spawn(libraries_[index].create, libraries_[index].name, config);
+}
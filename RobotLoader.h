@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Config.h"
+#include "RobotBase.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// A loaded robot shared object. The factory stays valid (and instances can be
+// created from any thread) for as long as the RobotLoader that owns it lives.
+struct RobotLibrary {
+    std::string path;
+    std::string name;     // m_name of a sample instance
+    void* handle;
+    RobotFactory create;
+};
+
+class RobotLoader {
+private:
+    std::vector<RobotLibrary> libraries_;
+    
+    bool openLibrary(const std::string& path, RobotLibrary& library);
+    
+public:
+    RobotLoader() = default;
+    ~RobotLoader();
+    RobotLoader(const RobotLoader&) = delete;
+    RobotLoader& operator=(const RobotLoader&) = delete;
+    
+    // dlopens every .so in the directory that exports create_robot; returns how many loaded
+    int loadDirectory(const std::string& directory);
+    bool loadLibrary(const std::string& path);
+    
+    // Swaps library 'index' for a freshly built one. Every instance from the old
+    // library must be gone; on failure the old library stays loaded.
+    bool reloadLibrary(int index, const std::string& path);
+    
+    const std::vector<RobotLibrary>& getLibraries() const { return libraries_; }
+    
+    // Fresh robot instance; must be destroyed before the loader
+    std::shared_ptr<RobotBase> create(int index) const;
+    // Same, but hosted in its own process when config.isolate_robots is set
+    std::shared_ptr<RobotBase> create(int index, const GameConfig& config) const;
+};
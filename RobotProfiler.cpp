@@ -0,0 +1,75 @@
+#include "RobotProfiler.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const char* const callback_names[RobotProfiler::CALLBACKS] = {
+    "radar direction", "radar results", "shot location", "move direction"
+};
+
+double microseconds(uint64_t ns) { return ns / 1000.0; }
+
+}
+
+RobotProfiler::RobotProfiler(int robots) : histograms_(robots * CALLBACKS) {}
+
+// 0..3 get a bucket each; above that, 4 buckets per power of two
+int RobotProfiler::bucketOf(uint64_t ns) {
+    if (ns < 4) return static_cast<int>(ns);
+    int msb = 63 - __builtin_clzll(ns);
+    return (msb - 1) * 4 + static_cast<int>((ns >> (msb - 2)) & 3);
+}
+
+// Largest value that lands in 'bucket'
+uint64_t RobotProfiler::bucketLimit(int bucket) {
+    if (bucket < 4) return bucket;
+    int msb = bucket / 4 + 1;
+    uint64_t width = uint64_t(1) << (msb - 2);
+    return (4 + bucket % 4) * width + width - 1;
+}
+
+uint64_t RobotProfiler::percentile(const Histogram& histogram, double fraction) {
+    uint64_t wanted = static_cast<uint64_t>(fraction * histogram.calls + 0.5);
+    if (wanted == 0) wanted = 1;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        seen += histogram.buckets[bucket];
+        if (seen >= wanted) return std::min(bucketLimit(bucket), histogram.max_ns);
+    }
+    return histogram.max_ns;
+}
+
+void RobotProfiler::record(int robot, Callback callback, uint64_t ns) {
+    Histogram& histogram = histograms_[robot * CALLBACKS + callback];
+    histogram.calls++;
+    histogram.total_ns += ns;
+    if (ns > histogram.max_ns) histogram.max_ns = ns;
+    histogram.buckets[bucketOf(ns)]++;
+}
+
+void RobotProfiler::printReport(const std::vector<std::string>& names) const {
+    uint64_t all_robots_ns = 0;
+    for (const auto& histogram : histograms_) all_robots_ns += histogram.total_ns;
+    
+    std::printf("\n════════════════════ ROBOT TIMING (µs) ════════════════════\n");
+    std::printf("%-16s %-16s %7s %9s %9s %9s %11s\n", "Robot", "Callback", "Calls", "p50", "p99", "max", "total");
+    for (size_t robot = 0; robot < names.size(); robot++) {
+        uint64_t think_ns = 0;
+        const char* label = names[robot].c_str();
+        for (int callback = 0; callback < CALLBACKS; callback++) {
+            const Histogram& histogram = histograms_[robot * CALLBACKS + callback];
+            think_ns += histogram.total_ns;
+            if (histogram.calls == 0) continue;
+            std::printf("%-16s %-16s %7llu %9.2f %9.2f %9.2f %11.1f\n",
+                        label, callback_names[callback],
+                        static_cast<unsigned long long>(histogram.calls),
+                        microseconds(percentile(histogram, 0.50)), microseconds(percentile(histogram, 0.99)),
+                        microseconds(histogram.max_ns), microseconds(histogram.total_ns));
+            label = "";
+        }
+        std::printf("%-16s %-16s %49.1f  (%.0f%% of all robot time)\n", "", "think time", microseconds(think_ns),
+                    all_robots_ns ? 100.0 * think_ns / all_robots_ns : 0.0);
+    }
+    std::fflush(stdout);
+}
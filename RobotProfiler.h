@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Latency of every robot callback, per robot and per callback, kept in
+// log-linear histograms (each power of two split into 4 sub-buckets, so any
+// percentile is within 25%). Storage is sized up front; recording a call is a
+// couple of clock reads and three adds.
+class RobotProfiler {
+public:
+    enum Callback { RADAR_DIRECTION, RADAR_RESULTS, SHOT_LOCATION, MOVE_DIRECTION, CALLBACKS };
+    
+    // Times one callback for as long as it is in scope (does nothing without a profiler)
+    class Timer {
+    private:
+        RobotProfiler* profiler_;
+        int robot_;
+        Callback callback_;
+        std::chrono::steady_clock::time_point start_;
+        
+    public:
+        Timer(RobotProfiler* profiler, int robot, Callback callback)
+            : profiler_(profiler), robot_(robot), callback_(callback) {
+            if (profiler_) start_ = std::chrono::steady_clock::now();
+        }
+        ~Timer() {
+            if (profiler_) {
+                auto elapsed = std::chrono::steady_clock::now() - start_;
+                profiler_->record(robot_, callback_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+        }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+    };
+    
+private:
+    static constexpr int BUCKETS = 256;
+    
+    struct Histogram {
+        uint64_t calls = 0;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+        uint32_t buckets[BUCKETS] = {};
+    };
+    
+    // robot * CALLBACKS + callback
+    std::vector<Histogram> histograms_;
+    
+    static int bucketOf(uint64_t ns);
+    static uint64_t bucketLimit(int bucket);
+    static uint64_t percentile(const Histogram& histogram, double fraction);
+    
+public:
+    explicit RobotProfiler(int robots);
+    
+    void record(int robot, Callback callback, uint64_t ns);
+    
+    // p50/p99/max per callback and each robot's total think time
+    void printReport(const std::vector<std::string>& names) const;
+};
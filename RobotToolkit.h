@@ -0,0 +1,130 @@
+#pragma once
+
+// Helpers for robot authors. Header-only: include it next to RobotBase.h and
+// nothing else needs to be linked. For path finding see FlowField.h.
+
+#include "RadarObj.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RobotToolkit {
+
+// What a robot has learned about the arena from its radar, one packed word per
+// cell: the obstacle there, the robot last seen standing on it and the turn it
+// was last seen. Updates and queries are O(1) and a scan is ingested in time
+// proportional to the scan, so think time does not grow with the map.
+//
+//   WorldMemory memory;
+//   void process_radar_results(const std::vector<RadarObj>& radar_results) override {
+//       memory.fitTo(m_board_row_max, m_board_col_max);
+//       memory.observe(radar_results);
+//       ...
+//   }
+//
+// Obstacles never move, so they are remembered until the cell is seen empty. A
+// robot standing on a flamethrower hides it: the flamethrower stays remembered
+// and the robot is recorded on top of it.
+class WorldMemory {
+public:
+    enum Obstacle : uint8_t { NONE = 0, MOUND = 1, PIT = 2, FLAMETHROWER = 3 };
+
+private:
+    // bits 0-1 obstacle, bits 2-9 robot character (0 = none), bits 10-31 turn (0 = never seen)
+    static constexpr uint32_t OBSTACLE_MASK = 0x3;
+    static constexpr int ROBOT_SHIFT = 2;
+    static constexpr uint32_t ROBOT_MASK = 0xFFu << ROBOT_SHIFT;
+    static constexpr int TURN_SHIFT = 10;
+    static constexpr uint32_t MAX_TURN = (1u << (32 - TURN_SHIFT)) - 1;
+
+    int rows_ = 0;
+    int cols_ = 0;
+    uint32_t turn_ = 0;
+    std::vector<uint32_t> cells_;
+
+    // Where each robot character was last seen (cell index, -1 = never)
+    std::array<int, 256> robot_cells_;
+
+    uint32_t cell(int row, int col) const { return cells_[row * cols_ + col]; }
+
+    static unsigned char robotBits(uint32_t word) { return (word & ROBOT_MASK) >> ROBOT_SHIFT; }
+
+public:
+    WorldMemory() { robot_cells_.fill(-1); }
+    WorldMemory(int rows, int cols) : WorldMemory() { fitTo(rows, cols); }
+
+    // Sizes the map for the arena (m_board_row_max, m_board_col_max), forgetting
+    // everything if the size changed. Cheap to call every turn.
+    void fitTo(int rows, int cols) {
+        if (rows == rows_ && cols == cols_) return;
+        rows_ = rows > 0 ? rows : 0;
+        cols_ = cols > 0 ? cols : 0;
+        cells_.assign(static_cast<size_t>(rows_) * cols_, 0);
+        robot_cells_.fill(-1);
+        turn_ = 0;
+    }
+
+    // Ingests one radar scan; every call counts as a new turn
+    void observe(const std::vector<RadarObj>& radar_results) {
+        if (turn_ < MAX_TURN) turn_++;
+        for (const RadarObj& object : radar_results) observeCell(object.m_type, object.m_row, object.m_col);
+    }
+
+    // Records what is in one cell as of the current turn
+    void observeCell(char type, int row, int col) {
+        if (!inBounds(row, col)) return;
+        int index = row * cols_ + col;
+        uint32_t obstacle = cells_[index] & OBSTACLE_MASK;
+
+        unsigned char robot = 0;
+        switch (type) {
+            case '.': obstacle = NONE; break;
+            case 'M': obstacle = MOUND; break;
+            case 'P': obstacle = PIT; break;
+            case 'F': obstacle = FLAMETHROWER; break;
+            default: robot = static_cast<unsigned char>(type); break;
+        }
+        if (robot) {
+            // A robot is in one place at a time
+            int previous = robot_cells_[robot];
+            if (previous >= 0 && robotBits(cells_[previous]) == robot) cells_[previous] &= ~ROBOT_MASK;
+            robot_cells_[robot] = index;
+        }
+        cells_[index] = obstacle | (uint32_t(robot) << ROBOT_SHIFT) | (turn_ << TURN_SHIFT);
+    }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    uint32_t turn() const { return turn_; }
+    bool inBounds(int row, int col) const { return row >= 0 && row < rows_ && col >= 0 && col < cols_; }
+
+    // Queries; cells outside the map read as never seen
+    bool known(int row, int col) const { return inBounds(row, col) && lastSeen(row, col) != 0; }
+    uint32_t lastSeen(int row, int col) const { return inBounds(row, col) ? cell(row, col) >> TURN_SHIFT : 0; }
+    Obstacle obstacle(int row, int col) const {
+        return inBounds(row, col) ? static_cast<Obstacle>(cell(row, col) & OBSTACLE_MASK) : NONE;
+    }
+    // Character of the robot last seen in the cell (if it has not been seen elsewhere since), 0 if none
+    char robotAt(int row, int col) const {
+        return inBounds(row, col) ? static_cast<char>(robotBits(cell(row, col))) : 0;
+    }
+
+    // Mounds and robots stop movement; pits and flamethrowers are hazards
+    bool isBlocked(int row, int col) const { return obstacle(row, col) == MOUND || robotAt(row, col) != 0; }
+    bool isHazard(int row, int col) const {
+        Obstacle type = obstacle(row, col);
+        return type == PIT || type == FLAMETHROWER;
+    }
+
+    // Where a robot was last seen (even if that cell has been seen empty since); false if never
+    bool lastSeenRobot(char robot, int& row, int& col) const {
+        int index = robot_cells_[static_cast<unsigned char>(robot)];
+        if (index < 0) return false;
+        row = index / cols_;
+        col = index % cols_;
+        return true;
+    }
+};
+
+}
@@ -0,0 +1,115 @@
+#include "RobotWatcher.h"
+#include "Tournament.h"
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+
+// Editors save in bursts (write, rename, chmod...); wait this long for quiet
+constexpr int SETTLE_MS = 50;
+
+bool isRobotSource(const std::string& name) {
+    return name.rfind("Robot_", 0) == 0 && name.size() > 10 && name.compare(name.size() - 4, 4, ".cpp") == 0;
+}
+
+}
+
+RobotWatcher::RobotWatcher(const GameConfig& config, RobotLoader& loader, const std::vector<RobotBuild>& builds)
+    : config_(config), builder_(config), loader_(loader) {
+    config_.watch_live = false;
+    for (const auto& library : loader_.getLibraries()) {
+        std::string source;
+        for (const auto& build : builds) {
+            if (build.library == library.path) source = build.source;
+        }
+        sources_.push_back(source);
+    }
+}
+
+int RobotWatcher::run() {
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd, config_.robot_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        perror("inotify");
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    std::cout << "\nWatching " << config_.robot_directory << " for Robot_*.cpp changes (Ctrl-C to stop)" << std::endl;
+    
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        std::set<std::string> changed;
+        int timeout = -1;   // block for the first event, then drain the burst
+        while (true) {
+            pollfd waiting = {fd, POLLIN, 0};
+            int ready = poll(&waiting, 1, timeout);
+            if (ready < 0) {
+                perror("poll");
+                close(fd);
+                return 1;
+            }
+            if (ready == 0) break;
+            
+            ssize_t length = read(fd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                perror("read");
+                close(fd);
+                return 1;
+            }
+            for (char* next = buffer; next < buffer + length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(next);
+                if (event->len > 0 && isRobotSource(event->name)) changed.insert(event->name);
+                next += sizeof(inotify_event) + event->len;
+            }
+            timeout = SETTLE_MS;
+        }
+        
+        for (const auto& name : changed) {
+            rebuild(config_.robot_directory + "/" + name);
+        }
+    }
+}
+
+void RobotWatcher::rebuild(const std::string& source) {
+    auto start = std::chrono::steady_clock::now();
+    std::cout << "\n═══ " << source << " changed ═══" << std::endl;
+    
+    RobotBuild build = builder_.build(source);
+    if (!build.ok) {
+        std::cout << "Build failed; fix it and save again" << std::endl;
+        return;
+    }
+    
+    int index = -1;
+    for (size_t i = 0; i < sources_.size(); i++) {
+        if (sources_[i] == source) index = i;
+    }
+    if (index >= 0 && loader_.getLibraries()[index].path == build.library) {
+        std::cout << "No change in the built robot" << std::endl;
+        return;
+    }
+    
+    // Nothing holds instances between batches, so the old handle can go right away
+    if (index >= 0) {
+        if (!loader_.reloadLibrary(index, build.library)) return;
+    } else {
+        if (!loader_.loadLibrary(build.library)) return;
+        index = sources_.size();
+        sources_.push_back(source);
+    }
+    
+    if (loader_.getLibraries().size() < 2) {
+        std::cout << "No other robots to play against" << std::endl;
+        return;
+    }
+    
+    Tournament tournament(loader_, config_);
+    tournament.runGauntlet(index, config_.watch_matches);
+    tournament.printStandings();
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Edit to result: " << seconds << " s" << std::endl;
+}
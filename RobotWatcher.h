@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Config.h"
+#include "RobotBuilder.h"
+#include "RobotLoader.h"
+#include <string>
+#include <vector>
+
+// Development loop: watches the robot directory with inotify and, whenever a
+// Robot_*.cpp is saved, rebuilds just that robot, swaps its library in place
+// and plays a quick gauntlet against every other loaded robot.
+class RobotWatcher {
+private:
+    GameConfig config_;
+    RobotBuilder builder_;
+    RobotLoader& loader_;
+    
+    // Source file behind each loaded library, by loader index
+    std::vector<std::string> sources_;
+    
+    void rebuild(const std::string& source);
+    
+public:
+    // 'builds' is what the loader's libraries were loaded from
+    RobotWatcher(const GameConfig& config, RobotLoader& loader, const std::vector<RobotBuild>& builds);
+    
+    // Blocks handling changes; only returns if the watch cannot be set up or read
+    int run();
+};
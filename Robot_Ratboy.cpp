@@ -1,7 +1,8 @@
 #include "RobotBase.h"
+#include "RobotToolkit.h"
 #include <vector>
 #include <iostream>
-#include <algorithm> // For std::find_if
+#include <algorithm> // For std::min
 
 class Robot_Ratboy : public RobotBase 
 {
@@ -10,16 +11,7 @@ private:
     int to_shoot_row = -1;   // Tracks the row of the next target to shoot
     int to_shoot_col = -1;   // Tracks the column of the next target to shoot
     
-    std::vector<RadarObj> known_obstacles; // Permanent obstacle list
-
-    // Helper function to determine if a cell is an obstacle
-    bool is_obstacle(int row, int col) const 
-    {
-        return std::any_of(known_obstacles.begin(), known_obstacles.end(), 
-                           [&](const RadarObj& obj) {
-                               return obj.m_row == row && obj.m_col == col;
-                           });
-    }
+    RobotToolkit::WorldMemory memory; // Everything the radar has shown so far
 
     // Clears the target when no enemy is found
     void clear_target() 
@@ -28,15 +20,6 @@ private:
         to_shoot_col = -1;
     }
 
-    // Helper function to add an obstacle to the list if it's not already there
-    void add_obstacle(const RadarObj& obj) 
-    {
-        if (obj.m_type == 'M' || obj.m_type == 'P' || obj.m_type == 'F' && 
-            !is_obstacle(obj.m_row, obj.m_col)) 
-        {
-            known_obstacles.push_back(obj);
-        }
-    }
 
 public:
     Robot_Ratboy() : RobotBase(3, 4, railgun) {m_name = "Ratboy"; m_character = 'R';} // Initialize with 3 movement, 4 armor, railgun
@@ -55,11 +38,12 @@ public:
     {
         clear_target();
 
+        // Remember obstacles and robots (sized on first use, boundaries come after construction)
+        memory.fitTo(m_board_row_max, m_board_col_max);
+        memory.observe(radar_results);
+
         for (const auto& obj : radar_results) 
         {
-            // Add static obstacles to the obstacle list
-            add_obstacle(obj);
-
             // Identify the first enemy found as the target
             if (obj.m_type == 'R' && to_shoot_row == -1 && to_shoot_col == -1) 
             {
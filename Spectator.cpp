@@ -0,0 +1,123 @@
+#include "Spectator.h"
+#include "Config.h"
+#include "Logger.h"
+#include "Replay.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Room for a keyframe and a few rounds before a client's backlog first grows
+constexpr size_t INITIAL_BACKLOG = 64 * 1024;
+
+}
+
+SpectatorServer::SpectatorServer(const GameConfig& config)
+    : path_(config.spectator_socket), listen_fd_(-1),
+      max_backlog_(static_cast<size_t>(std::max(config.spectator_max_backlog_kb, 1)) * 1024) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path_.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Spectator: socket path too long: " << path_ << std::endl;
+        return;
+    }
+    std::strcpy(address.sun_path, path_.c_str());
+    
+    // A socket left behind by an earlier run would make bind fail
+    struct stat info;
+    if (stat(path_.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) unlink(path_.c_str());
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 16) != 0) {
+        std::cerr << "Spectator: cannot listen on " << path_ << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0) close(fd);
+        return;
+    }
+    listen_fd_ = fd;
+    std::cout << "Spectators can connect to " << path_ << std::endl;
+}
+
+SpectatorServer::~SpectatorServer() {
+    // One last non-blocking attempt so clients that keep up see the END record
+    for (auto& client : clients_) {
+        flush(client);
+        close(client.fd);
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        unlink(path_.c_str());
+    }
+}
+
+bool SpectatorServer::flush(Client& client) {
+    while (client.sent < client.pending.size()) {
+        ssize_t written = send(client.fd, client.pending.data() + client.sent, client.pending.size() - client.sent,
+                               MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (written > 0) {
+            client.sent += written;
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    if (client.sent == client.pending.size()) {
+        client.pending.clear();
+        client.sent = 0;
+    } else if (client.sent > client.pending.size() / 2) {
+        // Keep the backlog at the front so it does not creep through memory
+        client.pending.erase(client.pending.begin(), client.pending.begin() + client.sent);
+        client.sent = 0;
+    }
+    return client.pending.size() - client.sent <= client.limit;
+}
+
+void SpectatorServer::dropClosed() {
+    auto closed = std::remove_if(clients_.begin(), clients_.end(), [](const Client& client) { return client.fd < 0; });
+    if (closed == clients_.end()) return;
+    clients_.erase(closed, clients_.end());
+    LOG_INFO(LogEvent::SpectatorDropped, clients_.size());
+}
+
+void SpectatorServer::broadcast(const char* data, size_t size) {
+    for (auto& client : clients_) {
+        client.pending.insert(client.pending.end(), data, data + size);
+        if (!flush(client)) {
+            close(client.fd);
+            client.fd = -1;
+        }
+    }
+    dropClosed();
+}
+
+void SpectatorServer::poll(int round, const Arena& arena, const ReplayRecorder& recorder) {
+    if (listen_fd_ < 0) return;
+    
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) break;    // EAGAIN: nobody else waiting (other errors: try again next round)
+        Client client;
+        client.fd = fd;
+        client.pending.reserve(INITIAL_BACKLOG);
+        recorder.encodeStreamStart(client.pending, round, arena);
+        client.limit = client.pending.size() + max_backlog_;
+        clients_.push_back(std::move(client));
+        LOG_INFO(LogEvent::SpectatorJoined, clients_.size());
+    }
+    
+    for (auto& client : clients_) {
+        if (!flush(client)) {
+            close(client.fd);
+            client.fd = -1;
+        }
+    }
+    dropClosed();
+}
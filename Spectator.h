@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class Arena;
+class ReplayRecorder;
+struct GameConfig;
+
+// Live match stream on a Unix domain socket (--spectate PATH). The stream is the
+// replay format without the file index: a client that connects gets the header
+// and a keyframe of the current state, then every following round's records
+// (ROUND, then its events) as the round ends, and END after the last one.
+//
+// Nothing here ever blocks the match. Sockets are non-blocking; bytes a client
+// has not taken yet wait in its backlog, and a client whose backlog passes
+// spectator_max_backlog_kb is disconnected (it can reconnect for a fresh keyframe).
+class SpectatorServer {
+private:
+    struct Client {
+        int fd;
+        std::vector<char> pending;
+        size_t sent = 0;
+        size_t limit;       // backlog allowed: the keyframe it started with plus the configured limit
+    };
+    
+    std::string path_;
+    int listen_fd_;
+    size_t max_backlog_;
+    std::vector<Client> clients_;
+    
+    // False once the client has failed or fallen too far behind
+    bool flush(Client& client);
+    void dropClosed();
+    
+public:
+    explicit SpectatorServer(const GameConfig& config);
+    ~SpectatorServer();
+    SpectatorServer(const SpectatorServer&) = delete;
+    SpectatorServer& operator=(const SpectatorServer&) = delete;
+    
+    bool isOpen() const { return listen_fd_ >= 0; }
+    int getClientCount() const { return clients_.size(); }
+    
+    // Queues bytes for every client and sends what each socket takes right now
+    void broadcast(const char* data, size_t size);
+    
+    // Called between rounds: admits waiting clients (starting them at the state
+    // after 'round') and keeps draining backlogs
+    void poll(int round, const Arena& arena, const ReplayRecorder& recorder);
+};
@@ -0,0 +1,129 @@
+#include "Sprt.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+#include "Tournament.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Expected score of a player 'elo' points stronger
+double eloToScore(double elo) { return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+
+double scoreToElo(double score) {
+    score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// Half a pair added to each pentanomial bin, so a run where every pair ended
+// the same way still has a variance and its LLR grows with every pair
+constexpr double PSEUDO_COUNT = 0.5;
+
+// Mean score per game and variance of the per-game score of a pair, smoothed
+// with PSEUDO_COUNT
+void scoreAndVariance(const long pairs[5], double& score, double& variance) {
+    double counts[5], n = 0, sum = 0;
+    for (int k = 0; k < 5; k++) {
+        counts[k] = pairs[k] + PSEUDO_COUNT;
+        n += counts[k];
+        sum += counts[k] * k / 4.0;
+    }
+    score = sum / n;
+    variance = 0;
+    for (int k = 0; k < 5; k++) variance += counts[k] * (k / 4.0 - score) * (k / 4.0 - score);
+    variance /= n;
+}
+
+}
+
+Sprt::Sprt(const RobotLoader& loader, const GameConfig& config, int candidate, int baseline)
+    : loader_(loader), config_(config), candidate_(candidate), baseline_(baseline),
+      wins_(0), draws_(0), losses_(0), pairs_{} {
+    config_.watch_live = false;
+}
+
+double Sprt::logLikelihoodRatio() const {
+    double n = pairs_[0] + pairs_[1] + pairs_[2] + pairs_[3] + pairs_[4];
+    if (n == 0) return 0.0;
+    double score, variance;
+    scoreAndVariance(pairs_, score, variance);
+    
+    double s0 = eloToScore(config_.sprt_elo0);
+    double s1 = eloToScore(config_.sprt_elo1);
+    return (s1 - s0) * (2 * score - s0 - s1) * n / (2 * variance);
+}
+
+void Sprt::printProgress(double llr) const {
+    long n = wins_ + draws_ + losses_;
+    double smoothed_score, variance;
+    scoreAndVariance(pairs_, smoothed_score, variance);
+    double score = (wins_ + 0.5 * draws_) / n;
+    double margin = 1.96 * std::sqrt(variance / (n / 2.0));
+    std::printf("%7ld matches  W-D-L %ld-%ld-%ld  pairs %ld-%ld-%ld-%ld-%ld  score %.3f  elo %+.1f [%+.1f, %+.1f]  LLR %.2f\n",
+                n, wins_, draws_, losses_, pairs_[0], pairs_[1], pairs_[2], pairs_[3], pairs_[4],
+                score, scoreToElo(score), scoreToElo(score - margin), scoreToElo(score + margin), llr);
+    std::fflush(stdout);
+}
+
+Sprt::Decision Sprt::run() {
+    const double lower = std::log(config_.sprt_beta / (1 - config_.sprt_alpha));
+    const double upper = std::log((1 - config_.sprt_beta) / config_.sprt_alpha);
+    const auto& libraries = loader_.getLibraries();
+    
+    uint64_t base_seed = config_.seed ? config_.seed : Rng::randomSeed();
+    std::printf("SPRT %s vs %s: H0 elo %.1f, H1 elo %.1f, alpha %.3f, beta %.3f, LLR bounds [%.2f, %.2f], seed %llu\n",
+                libraries[candidate_].name.c_str(), libraries[baseline_].name.c_str(),
+                config_.sprt_elo0, config_.sprt_elo1, config_.sprt_alpha, config_.sprt_beta, lower, upper,
+                static_cast<unsigned long long>(base_seed));
+    
+    ThreadPool pool(config_.worker_threads);
+    int pairs_per_batch = std::max(1, config_.sprt_batch / 2);
+    uint64_t next_pair = 0;
+    
+    while (wins_ + draws_ + losses_ < config_.sprt_max_matches) {
+        std::atomic<long> wins(0), draws(0), losses(0);
+        // Half points the candidate scored in each pair of this batch
+        std::vector<std::atomic<int>> pair_points(pairs_per_batch);
+        for (int p = 0; p < pairs_per_batch; p++) {
+            GameConfig match_config = config_;
+            match_config.seed = base_seed + next_pair++;
+            for (int swapped = 0; swapped < 2; swapped++) {
+                pool.submit([this, match_config, swapped, &wins, &draws, &losses, &points = pair_points[p]] {
+                    int first = swapped ? baseline_ : candidate_;
+                    int second = swapped ? candidate_ : baseline_;
+                    std::vector<std::shared_ptr<RobotBase>> robots = {loader_.create(first, match_config),
+                                                                       loader_.create(second, match_config)};
+                    MatchResult result = playMatch(match_config, robots);
+                    int candidate_slot = swapped ? 1 : 0;
+                    if (result.winner == candidate_slot) { wins++; points += 2; }
+                    else if (result.winner == 1 - candidate_slot) losses++;
+                    else { draws++; points += 1; }
+                });
+            }
+        }
+        pool.wait();
+        wins_ += wins;
+        draws_ += draws;
+        losses_ += losses;
+        for (auto& points : pair_points) pairs_[points]++;
+        
+        double llr = logLikelihoodRatio();
+        printProgress(llr);
+        if (wins_ + draws_ + losses_ < config_.sprt_min_matches) continue;
+        if (llr >= upper) {
+            std::printf("H1 accepted: %s is stronger (by at least ~%.0f elo)\n",
+                        libraries[candidate_].name.c_str(), config_.sprt_elo1);
+            return ACCEPT_H1;
+        }
+        if (llr <= lower) {
+            std::printf("H0 accepted: %s is not %.0f elo stronger\n",
+                        libraries[candidate_].name.c_str(), config_.sprt_elo1);
+            return ACCEPT_H0;
+        }
+    }
+    std::printf("Undecided after %d matches\n", config_.sprt_max_matches);
+    return UNDECIDED;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Config.h"
+#include "RobotLoader.h"
+
+// Head-to-head evaluation of a candidate robot against a baseline with a
+// sequential probability ratio test. Matches run in parallel batches; after
+// each batch the log-likelihood ratio between
+//     H0: candidate is elo0 stronger   and   H1: candidate is elo1 stronger
+// is updated and the run stops as soon as it crosses either bound, but never
+// before sprt_min_matches have been played.
+// Clear results stop early; close ones run until decided or sprt_max_matches.
+//
+// Matches come in pairs on the same seed with the robots' turn order swapped,
+// so going first is no advantage to either side. The two games of a pair are
+// not independent, so the pair is the sample: its total score (0, 0.5, ... 2)
+// falls into one of five bins (pentanomial), and the LLR is the generalized
+// SPRT with a normal approximation over the per-pair score. Each bin starts
+// with a pseudo-count of half a pair so a run where every pair ended the same
+// way still has a variance; that prior alone pushes a run of all draws toward
+// H0, which is why no decision is taken before the minimum.
+class Sprt {
+public:
+    enum Decision { UNDECIDED, ACCEPT_H0, ACCEPT_H1 };
+    
+private:
+    const RobotLoader& loader_;
+    GameConfig config_;
+    int candidate_;
+    int baseline_;
+    
+    // From the candidate's point of view
+    long wins_;
+    long draws_;
+    long losses_;
+    long pairs_[5];     // pairs by the candidate's total score in half points
+    
+    double logLikelihoodRatio() const;
+    void printProgress(double llr) const;
+    
+public:
+    Sprt(const RobotLoader& loader, const GameConfig& config, int candidate, int baseline);
+    
+    Decision run();
+};
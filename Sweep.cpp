@@ -0,0 +1,240 @@
+#include "Sweep.h"
+#include "Arena.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+#include "Tournament.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char* const sweep_fields[] = {
+    "rows", "cols", "size", "max_rounds", "mounds", "pits", "flamethrowers",
+    "mound_percent", "pit_percent", "flamethrower_percent"
+};
+
+std::string trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\r");
+    if (start == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(start, end - start + 1);
+}
+
+bool parseInt(const std::string& text, int& value) {
+    std::string number = trim(text);
+    if (number.empty()) return false;
+    size_t used = 0;
+    try {
+        value = std::stoi(number, &used);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return used == number.size();
+}
+
+// One finished match; written by exactly one job, read after the pool drains
+struct JobResult {
+    int rounds = 0;
+    std::vector<int> health;    // final health per robot (by loader index, not seat)
+    int winner = -1;            // loader index
+    int rotation = 0;           // robot in seat s is (s + rotation) % robot_count
+};
+
+}
+
+Sweep::Sweep() : seeds_(1) {}
+
+bool Sweep::parseValues(const std::string& text, std::vector<int>& values) {
+    if (text.find(':') != std::string::npos) {
+        std::vector<int> parts;
+        std::stringstream range(text);
+        std::string part;
+        while (std::getline(range, part, ':')) {
+            int value;
+            if (!parseInt(part, value)) return false;
+            parts.push_back(value);
+        }
+        if (parts.size() < 2 || parts.size() > 3) return false;
+        int step = parts.size() == 3 ? parts[2] : 1;
+        if (step <= 0 || parts[1] < parts[0]) return false;
+        for (int value = parts[0]; value <= parts[1]; value += step) values.push_back(value);
+        return true;
+    }
+    
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        int value;
+        if (!parseInt(item, value)) return false;
+        values.push_back(value);
+    }
+    return !values.empty();
+}
+
+bool Sweep::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "ERROR: cannot open sweep spec " << path << std::endl;
+        return false;
+    }
+    
+    std::string line;
+    for (int number = 1; std::getline(file, line); number++) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        
+        size_t equals = line.find('=');
+        std::string field = trim(line.substr(0, equals));
+        std::vector<int> values;
+        if (equals == std::string::npos || !parseValues(line.substr(equals + 1), values)) {
+            std::cerr << path << ":" << number << ": expected 'field = a, b, c' or 'field = start:end[:step]'" << std::endl;
+            return false;
+        }
+        
+        if (field == "seeds") {
+            if (values.size() != 1 || values[0] <= 0) {
+                std::cerr << path << ":" << number << ": seeds takes one positive number" << std::endl;
+                return false;
+            }
+            seeds_ = values[0];
+            continue;
+        }
+        if (std::find(std::begin(sweep_fields), std::end(sweep_fields), field) == std::end(sweep_fields)) {
+            std::cerr << path << ":" << number << ": unknown field '" << field << "'" << std::endl;
+            return false;
+        }
+        for (const auto& axis : axes_) {
+            if (axis.field == field) {
+                std::cerr << path << ":" << number << ": " << field << " given twice" << std::endl;
+                return false;
+            }
+        }
+        axes_.push_back({field, values});
+    }
+    return true;
+}
+
+GameConfig Sweep::configFor(const GameConfig& base, const std::vector<int>& point) const {
+    GameConfig config = base;
+    config.watch_live = false;
+    
+    // Sizes first: densities are relative to the final area
+    int mound_percent = 5, pit_percent = 2, flamethrower_percent = 1;
+    for (size_t i = 0; i < axes_.size(); i++) {
+        const std::string& field = axes_[i].field;
+        int value = point[i];
+        if (field == "rows") config.rows = value;
+        else if (field == "cols") config.cols = value;
+        else if (field == "size") config.rows = config.cols = value;
+        else if (field == "max_rounds") config.max_rounds = value;
+        else if (field == "mound_percent") mound_percent = value;
+        else if (field == "pit_percent") pit_percent = value;
+        else if (field == "flamethrower_percent") flamethrower_percent = value;
+    }
+    config.area = config.rows * config.cols;
+    config.mounds = mound_percent * config.area / 100;
+    config.pits = pit_percent * config.area / 100;
+    config.flamethrowers = flamethrower_percent * config.area / 100;
+    
+    // Absolute counts win over densities
+    for (size_t i = 0; i < axes_.size(); i++) {
+        if (axes_[i].field == "mounds") config.mounds = point[i];
+        else if (axes_[i].field == "pits") config.pits = point[i];
+        else if (axes_[i].field == "flamethrowers") config.flamethrowers = point[i];
+    }
+    return config;
+}
+
+bool Sweep::run(const RobotLoader& loader, const GameConfig& base, std::ostream& out) const {
+    int robot_count = loader.getLibraries().size();
+    
+    // Expand the grid, odometer style, skipping points whose obstacles do not fit
+    std::vector<std::vector<int>> points;
+    std::vector<int> digits(axes_.size(), 0);
+    while (true) {
+        std::vector<int> point;
+        for (size_t i = 0; i < axes_.size(); i++) point.push_back(axes_[i].values[digits[i]]);
+        std::string error = Arena::placementError(configFor(base, point), robot_count);
+        if (error.empty()) {
+            points.push_back(point);
+        } else {
+            std::cerr << "Skipping sweep point: " << error << std::endl;
+        }
+        
+        size_t axis = 0;
+        while (axis < axes_.size() && ++digits[axis] == static_cast<int>(axes_[axis].values.size())) {
+            digits[axis++] = 0;
+        }
+        if (axis == axes_.size()) break;
+    }
+    if (points.empty()) {
+        std::cerr << "ERROR: no runnable points in the sweep" << std::endl;
+        return false;
+    }
+    
+    // Job j plays with seed base + j, so a sweep reproduces from its seed
+    uint64_t base_seed = base.seed ? base.seed : Rng::randomSeed();
+    std::vector<JobResult> results(points.size() * seeds_);
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(base.worker_threads);
+        std::cerr << "Sweep: " << points.size() << " points x " << seeds_ << " seeds = " << results.size()
+                  << " matches on " << pool.size() << " thread(s), seed " << base_seed << std::endl;
+        
+        for (size_t job = 0; job < results.size(); job++) {
+            GameConfig config = configFor(base, points[job / seeds_]);
+            config.seed = base_seed + job;
+            // Seat order rotates with the seed so no robot always moves first
+            int rotation = (job % seeds_) % robot_count;
+            pool.submit([&loader, &results, robot_count, job, rotation, config] {
+                std::vector<std::shared_ptr<RobotBase>> robots;
+                for (int seat = 0; seat < robot_count; seat++) {
+                    robots.push_back(loader.create((seat + rotation) % robot_count, config));
+                }
+                
+                MatchResult match = playMatch(config, robots);
+                JobResult& result = results[job];
+                result.rounds = match.rounds;
+                result.winner = match.winner < 0 ? -1 : (match.winner + rotation) % robot_count;
+                result.rotation = rotation;
+                result.health.resize(robot_count);
+                for (int seat = 0; seat < robot_count; seat++) {
+                    result.health[(seat + rotation) % robot_count] = robots[seat]->get_health();
+                }
+            });
+        }
+        pool.wait();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    // One row per point, robot and seat it played from (seat 0 moves first)
+    for (const auto& axis : axes_) out << axis.field << ",";
+    out << "robot,seat,matches,wins,survived,avg_final_health,avg_rounds\n";
+    for (size_t p = 0; p < points.size(); p++) {
+        for (int robot = 0; robot < robot_count; robot++) {
+            for (int seat = 0; seat < robot_count; seat++) {
+                int matches = 0, wins = 0, survived = 0;
+                long health = 0, rounds = 0;
+                for (int seed = 0; seed < seeds_; seed++) {
+                    const JobResult& result = results[p * seeds_ + seed];
+                    if ((seat + result.rotation) % robot_count != robot) continue;
+                    matches++;
+                    wins += result.winner == robot;
+                    survived += result.health[robot] > 0;
+                    health += result.health[robot];
+                    rounds += result.rounds;
+                }
+                if (matches == 0) continue;
+                for (int value : points[p]) out << value << ",";
+                out << loader.getLibraries()[robot].name << "," << seat << "," << matches << "," << wins << ","
+                    << survived << "," << double(health) / matches << "," << double(rounds) / matches << "\n";
+            }
+        }
+    }
+    out.flush();
+    std::cerr << "Sweep finished in " << seconds << " s" << std::endl;
+    return true;
+}
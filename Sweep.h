@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Config.h"
+#include "RobotLoader.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Parameter sweep over GameConfig. A spec file lists values per field, one
+// field per line, as a list or an inclusive range, plus the seeds per point:
+//
+//     # comment
+//     size = 20, 40, 80            (sets rows and cols together)
+//     mound_percent = 0:30:10      (start:end[:step])
+//     max_rounds = 200
+//     seeds = 10
+//
+// Fields: rows, cols, size, max_rounds, mounds, pits, flamethrowers and the
+// density forms mound_percent, pit_percent, flamethrower_percent (of the arena
+// area). Obstacle fields that are not swept keep the default densities.
+//
+// Every point of the cartesian grid plays 'seeds' matches of all loaded robots
+// on the thread pool. The seat order (who moves first) rotates by one per seed,
+// so with a multiple of the robot count as 'seeds' every robot plays every seat
+// equally often. One CSV row per point, robot and seat comes out at the end.
+class Sweep {
+private:
+    struct Axis {
+        std::string field;
+        std::vector<int> values;
+    };
+    std::vector<Axis> axes_;
+    int seeds_;
+    
+    static bool parseValues(const std::string& text, std::vector<int>& values);
+    GameConfig configFor(const GameConfig& base, const std::vector<int>& point) const;
+    
+public:
+    Sweep();
+    
+    // Reads a spec file; reports problems on std::cerr
+    bool load(const std::string& path);
+    
+    // Plays the whole grid and writes the results table to 'out'
+    bool run(const RobotLoader& loader, const GameConfig& base, std::ostream& out) const;
+};
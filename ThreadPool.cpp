@@ -0,0 +1,97 @@
+#include "ThreadPool.h"
+
+namespace {
+
+// Index of the pool worker running on this thread, -1 elsewhere
+thread_local int current_worker = -1;
+thread_local const void* current_pool = nullptr;
+
+}
+
+ThreadPool::ThreadPool(int threads)
+    : next_worker_(0), queued_(0), pending_(0), stopping_(false) {
+    if (threads <= 0) threads = std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    
+    for (int i = 0; i < threads; i++) {workers_.push_back(std::make_unique<Worker>());}
+    for (int i = 0; i < threads; i++) {threads_.emplace_back(&ThreadPool::workerLoop, this, i);}
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& thread : threads_) {thread.join();}
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Workers keep what they spawn (good locality); outsiders spread the load
+    size_t target = (current_pool == this) ? current_worker : next_worker_++ % workers_.size();
+    pending_++;
+    {
+        std::lock_guard<std::mutex> lock(workers_[target]->mutex);
+        workers_[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        queued_++;
+    }
+    work_available_.notify_one();
+}
+
+bool ThreadPool::runOne(int self) {
+    std::function<void()> task;
+    int count = static_cast<int>(workers_.size());
+    
+    // Own deque from the back, then steal from the front of the others
+    for (int k = 0; k < count && !task; k++) {
+        Worker& worker = *workers_[(self + k) % count];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.head == worker.tasks.size()) continue;
+        if (k == 0) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        } else {
+            task = std::move(worker.tasks[worker.head++]);
+        }
+        if (worker.head == worker.tasks.size()) {
+            worker.tasks.clear();
+            worker.head = 0;
+        }
+    }
+    if (!task) return false;
+    
+    queued_--;
+    task();
+    if (--pending_ == 0) {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        all_done_.notify_all();
+    }
+    return true;
+}
+
+void ThreadPool::workerLoop(int self) {
+    current_worker = self;
+    current_pool = this;
+    while (true) {
+        if (runOne(self)) continue;
+        
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        work_available_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) return;
+    }
+}
+
+void ThreadPool::wait() {
+    // A worker waiting on its own pool helps out instead of blocking a thread
+    if (current_pool == this) {
+        while (pending_ > 0) {
+            if (!runOne(current_worker)) std::this_thread::yield();
+        }
+        return;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    all_done_.wait(lock, [this] { return pending_ == 0; });
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Every worker owns a deque: it pushes and pops its
+// own tasks at the back and, when empty, steals from the front of the others.
+// Tasks submitted from outside the pool are spread round-robin.
+class ThreadPool {
+private:
+    // The deque is a vector plus a front index, reset whenever it drains, so a
+    // pool fed small tasks every round stops touching the heap once warm
+    struct Worker {
+        std::mutex mutex;
+        std::vector<std::function<void()>> tasks;
+        size_t head = 0;
+    };
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    
+    std::atomic<size_t> next_worker_;
+    std::atomic<long> queued_;     // tasks sitting in a deque
+    std::atomic<long> pending_;    // tasks submitted but not yet finished
+    bool stopping_;
+    
+    std::mutex sleep_mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable all_done_;
+    
+    bool runOne(int self);
+    void workerLoop(int self);
+    
+public:
+    // threads <= 0 uses every hardware thread
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    void submit(std::function<void()> task);
+    
+    // Blocks until every submitted task has finished
+    void wait();
+    
+    int size() const { return static_cast<int>(workers_.size()); }
+};
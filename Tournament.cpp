@@ -0,0 +1,121 @@
+#include "Tournament.h"
+#include "Arena.h"
+#include "EventHandler.h"
+#include "ThreadPool.h"
+#include "Rng.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+MatchResult playMatch(const GameConfig& config, const std::vector<std::shared_ptr<RobotBase>>& robots) {
+    Arena arena(config, robots);
+    EventHandler event_handler(arena, config);
+    
+    MatchResult result = {-1, 0, 0};
+    for (int round = 1; round <= config.max_rounds; round++) {
+        event_handler.playRound(round);
+        result.rounds = round;
+        if (event_handler.checkForWinner()) break;
+    }
+    
+    result.survivors = arena.getAliveCount();
+    if (result.survivors == 1) result.winner = arena.getAliveRobots().front();
+    return result;
+}
+
+Tournament::Tournament(const RobotLoader& loader, const GameConfig& config)
+    : loader_(loader), config_(config),
+      standings_(loader.getLibraries().size()), matches_(0), seconds_(0) {
+    config_.watch_live = false;
+}
+
+void Tournament::recordResult(int first, int second, bool swapped, const MatchResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    matches_++;
+    // Players in seat order, matching result.winner
+    const int players[2] = {swapped ? second : first, swapped ? first : second};
+    for (int i = 0; i < 2; i++) {
+        Standing& standing = standings_[players[i]];
+        standing.played++;
+        standing.rounds += result.rounds;
+        if (result.winner == i) standing.wins++;
+        else if (result.winner == 1 - i) standing.losses++;
+        else standing.draws++;
+    }
+}
+
+void Tournament::run(int repeats) {
+    int count = loader_.getLibraries().size();
+    std::vector<std::pair<int, int>> pairs;
+    for (int first = 0; first < count; first++) {
+        for (int second = first + 1; second < count; second++) {pairs.push_back({first, second});}
+    }
+    playPairs(pairs, repeats);
+}
+
+void Tournament::runGauntlet(int robot, int repeats) {
+    int count = loader_.getLibraries().size();
+    std::vector<std::pair<int, int>> pairs;
+    for (int other = 0; other < count; other++) {
+        if (other != robot) pairs.push_back({robot, other});
+    }
+    playPairs(pairs, repeats);
+}
+
+void Tournament::playPairs(const std::vector<std::pair<int, int>>& pairs, int repeats) {
+    // Match i plays with seed base + i, so a tournament is reproducible whatever
+    // order the workers happen to pick the matches up in
+    uint64_t base_seed = config_.seed ? config_.seed : Rng::randomSeed();
+    auto start = std::chrono::steady_clock::now();
+    
+    {
+        ThreadPool pool(config_.worker_threads);
+        std::cout << "Tournament: " << pairs.size() * repeats << " matches on "
+                  << pool.size() << " thread(s), seed " << base_seed << std::endl;
+        
+        uint64_t match = 0;
+        for (const auto& [first, second] : pairs) {
+            for (int repeat = 0; repeat < repeats; repeat++) {
+                GameConfig match_config = config_;
+                match_config.seed = base_seed + match++;
+                // Seat 0 moves first each round: alternate who gets it
+                bool swapped = repeat % 2 == 1;
+                pool.submit([this, first, second, swapped, match_config] {
+                    int seat0 = swapped ? second : first;
+                    int seat1 = swapped ? first : second;
+                    std::vector<std::shared_ptr<RobotBase>> robots = {loader_.create(seat0, match_config),
+                                                                       loader_.create(seat1, match_config)};
+                    recordResult(first, second, swapped, playMatch(match_config, robots));
+                });
+            }
+        }
+        pool.wait();
+    }
+    
+    seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Tournament::printStandings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto& libraries = loader_.getLibraries();
+    
+    std::vector<int> order(standings_.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return standings_[a].wins != standings_[b].wins ? standings_[a].wins > standings_[b].wins
+                                                        : standings_[a].losses < standings_[b].losses;
+    });
+    
+    std::cout << "\n════════════════════ TOURNAMENT ════════════════════" << std::endl;
+    std::printf("%-20s %7s %6s %6s %6s %10s\n", "Robot", "Played", "Wins", "Losses", "Draws", "Avg rounds");
+    for (int index : order) {
+        const Standing& standing = standings_[index];
+        double average_rounds = standing.played ? double(standing.rounds) / standing.played : 0.0;
+        std::printf("%-20s %7d %6d %6d %6d %10.1f\n", libraries[index].name.c_str(), standing.played,
+                    standing.wins, standing.losses, standing.draws, average_rounds);
+    }
+    std::printf("\n%d matches in %.2f s (%.1f matches/s)\n", matches_, seconds_,
+                seconds_ > 0 ? matches_ / seconds_ : 0.0);
+    std::fflush(stdout);
+}
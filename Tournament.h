@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Config.h"
+#include "RobotBase.h"
+#include "RobotLoader.h"
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+struct MatchResult {
+    int winner;     // index into the match's robot list, -1 if no single survivor
+    int survivors;
+    int rounds;
+};
+
+// Plays one match start to finish with no display
+MatchResult playMatch(const GameConfig& config, const std::vector<std::shared_ptr<RobotBase>>& robots);
+
+// Round-robin tournament: every pair of loaded robots plays a number of
+// independent matches, scheduled across all cores. Each match builds its own
+// Arena/EventHandler and fresh robot instances from the cached factories.
+// The two robots swap seats on every other repeat, so neither always moves first.
+class Tournament {
+private:
+    const RobotLoader& loader_;
+    GameConfig config_;
+    
+    struct Standing {
+        int played = 0;
+        int wins = 0;
+        int losses = 0;
+        int draws = 0;
+        long rounds = 0;
+    };
+    
+    // Filled in by worker threads
+    mutable std::mutex mutex_;
+    std::vector<Standing> standings_;
+    int matches_;
+    double seconds_;
+    
+    // 'swapped' when 'second' sat in seat 0 (and so moved first)
+    void recordResult(int first, int second, bool swapped, const MatchResult& result);
+    void playPairs(const std::vector<std::pair<int, int>>& pairs, int repeats);
+    
+public:
+    Tournament(const RobotLoader& loader, const GameConfig& config);
+    
+    // Every pair plays 'repeats' matches
+    void run(int repeats);
+    // Only 'robot' against every other robot, 'repeats' matches each
+    void runGauntlet(int robot, int repeats);
+    void printStandings() const;
+};
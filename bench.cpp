@@ -0,0 +1,269 @@
+// Microbenchmarks for the engine's hot paths.
+//
+//   robotwarz_bench [--sizes 10,64,256,1024,4096] [--format table|csv|json] [--min-time-ms N]
+//
+// Every benchmark runs for at least the minimum time and reports ns/op and heap
+// allocations/op (robot code excluded, as in --alloc-check). The CSV and JSON
+// forms are meant for diffing runs before and after an engine change.
+#include "Arena.h"
+#include "EventHandler.h"
+#include "AllocTracker.h"
+#include "Logger.h"
+#include "FlowField.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Stands still and never shoots; benchmarks drive the engine directly
+class BenchRobot : public RobotBase {
+public:
+    BenchRobot(char character, WeaponType weapon) : RobotBase(5, 0, weapon) {
+        m_name = std::string("Bench_") + character;
+        m_character = character;
+    }
+    void get_radar_direction(int& radar_direction) override { radar_direction = 0; }
+    void process_radar_results(const std::vector<RadarObj>&) override {}
+    bool get_shot_location(int&, int&) override { return false; }
+    void get_move_direction(int& direction, int& distance) override { direction = 0; distance = 0; }
+};
+
+// Swallows everything written to it
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+struct Result {
+    std::string name;
+    int size;
+    long iterations;
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+std::vector<Result> results;
+double min_time_ms = 100;
+
+// Doubles the batch until one batch takes at least the minimum time
+void measure(const std::string& name, int size, const std::function<void()>& op) {
+    op();   // warm caches and lazily sized buffers
+    long iterations = 1;
+    while (true) {
+        AllocTracker::reset();
+        AllocTracker::enable(true);
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < iterations; i++) op();
+        double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        AllocTracker::enable(false);
+        
+        if (elapsed_ns >= min_time_ms * 1e6 || iterations >= (1L << 30)) {
+            results.push_back({name, size, iterations, elapsed_ns / iterations,
+                               double(AllocTracker::count()) / iterations});
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+GameConfig configFor(int size, int mound_percent, int pit_percent, int flame_percent) {
+    GameConfig config;
+    config.rows = config.cols = size;
+    config.area = size * size;
+    config.mounds = mound_percent * config.area / 100;
+    config.pits = pit_percent * config.area / 100;
+    config.flamethrowers = flame_percent * config.area / 100;
+    config.watch_live = false;
+    config.seed = 12345;
+    return config;
+}
+
+std::vector<std::shared_ptr<RobotBase>> benchRobots() {
+    return {std::make_shared<BenchRobot>('R', railgun), std::make_shared<BenchRobot>('F', flamethrower),
+            std::make_shared<BenchRobot>('H', hammer), std::make_shared<BenchRobot>('G', grenade)};
+}
+
+void benchSize(int size) {
+    // Placement on its own: an arena with the default obstacle mix, built from scratch
+    GameConfig config = configFor(size, 5, 2, 1);
+    measure("place_obstacles", size, [&] {
+        Arena arena(config, {});
+    });
+    
+    {
+        Arena arena(config, benchRobots());
+        EventHandler event_handler(arena, config);
+        
+        for (int direction = 0; direction <= 8; direction++) {
+            measure("scan_radar_" + std::to_string(direction), size, [&] {
+                event_handler.scanRadar(0, direction);
+            });
+        }
+        
+        GameConfig sparse_config = config;
+        sparse_config.sparse_radar = true;
+        EventHandler sparse_handler(arena, sparse_config);
+        int direction = 0;
+        measure("scan_radar_sparse", size, [&] {
+            sparse_handler.scanRadar(0, direction);
+            direction = direction % 8 + 1;
+        });
+        
+        // Shots at a spread of targets around the shooter, so the shot path cache
+        // sees both hits and misses. Grenades are left out: they run dry after 15.
+        const char* weapon_names[] = {"process_shot_railgun", "process_shot_flamethrower", "process_shot_hammer"};
+        for (int shooter = 0; shooter < 3; shooter++) {
+            int row, col;
+            arena.getRobots()[shooter]->get_current_location(row, col);
+            int target = 0;
+            measure(weapon_names[shooter], size, [&] {
+                int offset = target++ % 16;
+                event_handler.processShot(shooter, (row + offset - 8 + size) % size, (col + 3 * offset + 1) % size);
+            });
+        }
+        
+        // The same one-off frame Arena::printArena builds, written to a null stream
+        NullBuffer null_buffer;
+        std::streambuf* console = std::cout.rdbuf(&null_buffer);
+        measure("print_arena", size, [&] {
+            arena.printArena();
+        });
+        std::cout.rdbuf(console);
+    }
+    
+    {
+        // Movement through a field of mounds (no pits or flames to trap or kill the mover)
+        GameConfig dense = configFor(size, 25, 0, 0);
+        Arena arena(dense, benchRobots());
+        EventHandler event_handler(arena, dense);
+        int direction = 3;
+        measure("process_movement", size, [&] {
+            event_handler.processMovement(0, direction, 5);
+            direction = direction == 3 ? 7 : 3;
+        });
+    }
+    
+    {
+        // Longer moves over open ground: few mounds, no pits to end the run
+        GameConfig open = configFor(size, 5, 0, 1);
+        Arena arena(open, benchRobots());
+        EventHandler event_handler(arena, open);
+        int direction = 3;
+        measure("process_movement_open", size, [&] {
+            event_handler.processMovement(0, direction, 5);
+            direction = direction == 3 ? 7 : 3;
+        });
+    }
+    
+    {
+        // Snapshots a few moves apart: taking one shares every page untouched since
+        // the last, restoring flips between the two and rewrites only what differs
+        Arena arena(config, benchRobots());
+        EventHandler event_handler(arena, config);
+        ArenaSnapshot before = event_handler.takeSnapshot();
+        for (int direction = 1; direction <= 8; direction++) {event_handler.processMovement(0, direction, 5);}
+        ArenaSnapshot after = event_handler.takeSnapshot();
+        measure("take_snapshot", size, [&] {
+            ArenaSnapshot snapshot = event_handler.takeSnapshot();
+        });
+        bool flip = false;
+        measure("restore_snapshot", size, [&] {
+            event_handler.restoreSnapshot(flip ? before : after);
+            flip = !flip;
+        });
+    }
+    
+    {
+        // Path finding to one robot over the arena: a full solve, then the
+        // incremental update for a mound appearing and vanishing near the goal
+        Arena arena(config, benchRobots());
+        FlowField field(size, size);
+        for (int row = 0; row < size; row++) {
+            for (int col = 0; col < size; col++) field.setCost(row, col, FlowField::costOf(arena.getCell(row, col)));
+        }
+        int goal_row = arena.getRobotRow(0), goal_col = arena.getRobotCol(0);
+        field.setGoal(goal_row, goal_col, true);
+        measure("flow_field_full", size, [&] {
+            field.invalidate();
+            field.update();
+        });
+        int row = (goal_row + 2) % size, col = goal_col;
+        uint8_t cost = FlowField::costOf(arena.getCell(row, col));
+        bool blocked = false;
+        measure("flow_field_update", size, [&] {
+            blocked = !blocked;
+            field.setCost(row, col, blocked ? 0 : cost);
+            field.update();
+        });
+    }
+}
+
+void printResults(const std::string& format) {
+    if (format == "csv") {
+        std::printf("benchmark,size,iterations,ns_per_op,allocs_per_op\n");
+        for (const auto& r : results) {
+            std::printf("%s,%d,%ld,%.2f,%.3f\n", r.name.c_str(), r.size, r.iterations, r.ns_per_op, r.allocs_per_op);
+        }
+    } else if (format == "json") {
+        std::printf("[\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const auto& r = results[i];
+            std::printf("  {\"benchmark\": \"%s\", \"size\": %d, \"iterations\": %ld, \"ns_per_op\": %.2f, "
+                        "\"allocs_per_op\": %.3f}%s\n", r.name.c_str(), r.size, r.iterations, r.ns_per_op,
+                        r.allocs_per_op, i + 1 < results.size() ? "," : "");
+        }
+        std::printf("]\n");
+    } else {
+        std::printf("%-28s %6s %12s %14s %12s\n", "Benchmark", "Size", "Iterations", "ns/op", "allocs/op");
+        for (const auto& r : results) {
+            std::printf("%-28s %6d %12ld %14.1f %12.3f\n", r.name.c_str(), r.size, r.iterations, r.ns_per_op,
+                        r.allocs_per_op);
+        }
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes = {10, 64, 256, 1024, 4096};
+    std::string format = "table";
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream list(argv[++i]);
+            std::string size;
+            while (std::getline(list, size, ',')) sizes.push_back(std::atoi(size.c_str()));
+        } else if (arg == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (arg == "--min-time-ms" && i + 1 < argc) {
+            min_time_ms = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--sizes 10,64,...] [--format table|csv|json] [--min-time-ms N]" << std::endl;
+            return 1;
+        }
+    }
+    
+    // Arena setup logs at Info; keep it out of the numbers and the output
+    Logger::setLevel(LogLevel::Warning);
+    
+    for (int size : sizes) {
+        if (size < 4) {
+            std::cerr << "Arena size must be at least 4" << std::endl;
+            return 1;
+        }
+        benchSize(size);
+    }
+    printResults(format);
+    return 0;
+}
@@ -2,67 +2,255 @@
 #include "Config.h"
 #include "RobotBase.h"
 #include "EventHandler.h"
+#include "AllocTracker.h"
+#include "Logger.h"
+#include "Replay.h"
+#include "Spectator.h"
+#include "RobotProfiler.h"
+#include "RobotLoader.h"
+#include "RobotBuilder.h"
+#include "RobotWatcher.h"
+#include "ThreadPool.h"
+#include "Tournament.h"
+#include "Sweep.h"
+#include "Sprt.h"
+#include "FlowField.h"
 #include <iostream>
+#include <fstream>
 #include <memory>
 #include <vector>
-#include <dlfcn.h>
-#include <filesystem>
 #include <chrono>
 #include <thread>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
 
-namespace fs = std::filesystem;
+// Rounds played before --alloc-check starts counting, so buffers and caches can warm up
+constexpr int ALLOC_CHECK_WARMUP_ROUNDS = 5;
 
-int main() {
+// --sprt takes a loaded robot's name or a path to a .so (loaded if it is not already)
+int findRobot(RobotLoader& loader, const std::string& spec) {
+    const auto& libraries = loader.getLibraries();
+    for (size_t i = 0; i < libraries.size(); i++) {
+        if (libraries[i].path == spec || libraries[i].name == spec) return i;
+    }
+    if (spec.size() > 3 && spec.compare(spec.size() - 3, 3, ".so") == 0 && loader.loadLibrary(spec)) {
+        return loader.getLibraries().size() - 1;
+    }
+    std::cerr << "ERROR: no robot named or at '" << spec << "'" << std::endl;
+    return -1;
+}
+
+// --analyze: how far apart the robots really are, walking round mounds, pits and
+// flamethrowers, on the arena this seed builds
+void analyzeArena(const Arena& arena) {
+    const auto& robots = arena.getRobots();
+    FlowField field(arena.getRows(), arena.getCols());
+    for (int row = 0; row < arena.getRows(); row++) {
+        for (int col = 0; col < arena.getCols(); col++) field.setCost(row, col, FlowField::costOf(arena.getCell(row, col)));
+    }
+    
+    std::cout << "\n=== PATH ANALYSIS (step cost: empty 1, flamethrower 8) ===" << std::endl;
+    std::printf("%-4s %-20s %10s %12s", "Id", "Robot", "Reachable", "Solve (us)");
+    for (size_t other = 0; other < robots.size(); other++) std::printf(" %6s", ("to " + std::to_string(other)).c_str());
+    std::printf("\n");
+    
+    for (size_t id = 0; id < robots.size(); id++) {
+        // Every other robot's distance to this one, solved from scratch
+        field.clearGoals();
+        field.setGoal(arena.getRobotRow(id), arena.getRobotCol(id), true);
+        field.invalidate();
+        auto start = std::chrono::steady_clock::now();
+        field.update();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        
+        // Open cells this robot can be reached from
+        int reachable = 0;
+        for (int row = 0; row < arena.getRows(); row++) {
+            for (int col = 0; col < arena.getCols(); col++) {
+                reachable += FlowField::costOf(arena.getCell(row, col)) != 0 &&
+                             field.distance(row, col) != FlowField::UNREACHABLE;
+            }
+        }
+        std::printf("%-4zu %-20s %10d %12.1f", id, robots[id]->m_name.c_str(), reachable, us);
+        for (size_t other = 0; other < robots.size(); other++) {
+            uint32_t distance = field.distance(arena.getRobotRow(other), arena.getRobotCol(other));
+            if (distance == FlowField::UNREACHABLE) std::printf(" %6s", "-");
+            else std::printf(" %6u", distance);
+        }
+        std::printf("\n");
+    }
+    std::fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
     std::cout << "=== ROBOTWARZ - LOADING ROBOTS FROM .so FILES ===\n" << std::endl;
     
     // Use DEFAULT config
     GameConfig config;
     
-    std::cout << "Config: " << config.rows << "x" << config.cols << " arena" << std::endl;
-    std::cout << "Looking for robot .so files in: " << config.robot_directory << std::endl;
+    // --alloc-check: run headless and fail if steady-state rounds allocate
+    // --record FILE: write a replay of the match
+    // --spectate PATH: stream the match live on a Unix socket (see Spectator.h)
+    // --replay FILE ROUND: show the recorded state after ROUND and exit
+    // --tournament N: every pair of robots plays N headless matches
+    // --sprt NEW OLD: play NEW against OLD until an SPRT decides which is stronger
+    // --sweep SPEC [--out FILE]: play a parameter grid (see Sweep.h), results as CSV
+    // --threads N: worker threads for tournaments and robot builds (0 = all cores)
+    // --simultaneous: all robots decide at once (in parallel), then the round resolves
+    // --profile: report per-robot callback latency after the match
+    // --isolate: run every robot in its own process with a per-callback time budget
+    // --build-robots: compile Robot_*.cpp (cached by content hash) instead of loading .so files
+    // --watch: build robots, then rebuild, reload and retest each Robot_*.cpp as it is saved
+    // --analyze: print path distances between the robots on the seeded arena and exit
+    // --seed N: reproduce a match (or tournament) from its seed
+    bool alloc_check = false;
+    bool analyze = false;
+    bool build_robots = false;
+    bool watch = false;
+    int tournament_repeats = 0;
+    std::string sweep_spec;
+    std::string sweep_output = "sweep_results.csv";
+    std::string sprt_candidate;
+    std::string sprt_baseline;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--alloc-check") {
+            alloc_check = true;
+            config.watch_live = false;
+        } else if (arg == "--analyze") {
+            analyze = true;
+        } else if (arg == "--simultaneous") {
+            config.simultaneous_turns = true;
+        } else if (arg == "--profile") {
+            config.profile_robots = true;
+        } else if (arg == "--isolate") {
+            config.isolate_robots = true;
+        } else if (arg == "--build-robots") {
+            build_robots = true;
+        } else if (arg == "--watch") {
+            build_robots = watch = true;
+        } else if (arg == "--record" && i + 1 < argc) {
+            config.replay_file = argv[++i];
+        } else if (arg == "--spectate" && i + 1 < argc) {
+            config.spectator_socket = argv[++i];
+        } else if (arg == "--tournament" && i + 1 < argc) {
+            tournament_repeats = std::atoi(argv[++i]);
+        } else if (arg == "--sprt" && i + 2 < argc) {
+            sprt_candidate = argv[++i];
+            sprt_baseline = argv[++i];
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            sweep_spec = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            sweep_output = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.worker_threads = std::atoi(argv[++i]);
+        } else if (arg == "--replay" && i + 2 < argc) {
+            ReplayPlayer player;
+            if (!player.open(argv[i + 1]) || !player.seek(std::atoi(argv[i + 2]))) {
+                return 1;
+            }
+            player.print();
+            return 0;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
     
-    std::vector<std::shared_ptr<RobotBase>> robots;
+    Logger::setLevel(config.verbose_logging ? LogLevel::Debug : LogLevel::Info);
     
-    // Load .so files
-    try {
-        for (const auto& entry : fs::directory_iterator(config.robot_directory)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".so") {
-                std::string so_file = entry.path().string();
-                std::cout << "Loading: " << so_file << std::endl;
-                
-                void* handle = dlopen(so_file.c_str(), RTLD_LAZY);
-                if (!handle) {
-                    std::cerr << "  ERROR: " << dlerror() << std::endl;
-                    continue;
-                }
-                
-                dlerror(); // Clear errors
-                RobotFactory create_robot = (RobotFactory)dlsym(handle, "create_robot");
-                
-                if (dlerror()) {
-                    std::cerr << "  ERROR: No create_robot() function" << std::endl;
-                    dlclose(handle);
-                    continue;
-                }
-                
-                RobotBase* robot_ptr = create_robot();
-                if (robot_ptr) {
-                    robots.push_back(std::shared_ptr<RobotBase>(robot_ptr, 
-                        [handle](RobotBase* rb) { delete rb; dlclose(handle); }));
-                    std::cout << "  SUCCESS: Loaded " << robot_ptr->m_name << std::endl;
-                }
-            }
+    std::cout << "Config: " << config.rows << "x" << config.cols << " arena" << std::endl;
+    
+    // Declared before any robot so the libraries outlive every instance
+    RobotLoader loader;
+    std::vector<RobotBuild> builds;
+    if (build_robots) {
+        std::cout << "Building Robot_*.cpp in: " << config.robot_directory << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        RobotBuilder builder(config);
+        {
+            ThreadPool pool(config.worker_threads);
+            builds = builder.buildAll(pool);
+        }
+        int compiled = 0;
+        for (const auto& build : builds) {
+            if (!build.ok) continue;
+            if (!build.cached) compiled++;
+            loader.loadLibrary(build.library);
         }
-    } catch (const std::exception& e) {
-        std::cerr << "Directory error: " << e.what() << std::endl;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Built " << compiled << " of " << builds.size() << " robot(s) in " << seconds
+                  << " s (the rest were cached)" << std::endl;
+    } else {
+        std::cout << "Looking for robot .so files in: " << config.robot_directory << std::endl;
+        loader.loadDirectory(config.robot_directory);
+    }
+    
+    int candidate = -1;
+    int baseline = -1;
+    if (!sprt_candidate.empty()) {
+        candidate = findRobot(loader, sprt_candidate);
+        baseline = findRobot(loader, sprt_baseline);
+        if (candidate < 0 || baseline < 0) return 1;
     }
     
-    if (robots.empty()) {
+    if (loader.getLibraries().empty()) {
         std::cerr << "\nERROR: No robots loaded. Place robot .so files in: " 
                   << config.robot_directory << std::endl;
         return 1;
     }
     
+    if (!sweep_spec.empty()) {
+        // Each point is checked on its own; the default config does not matter here
+        Logger::setLevel(LogLevel::Warning);
+        Sweep sweep;
+        std::ofstream output(sweep_output);
+        if (!output) {
+            std::cerr << "ERROR: cannot write " << sweep_output << std::endl;
+            return 1;
+        }
+        if (!sweep.load(sweep_spec) || !sweep.run(loader, config, output)) return 1;
+        std::cout << "Results written to " << sweep_output << std::endl;
+        return 0;
+    }
+    
+    // Tournaments and watch mode play head-to-head; a plain match seats everyone
+    size_t robots_per_match = (watch || tournament_repeats > 0 || candidate >= 0) ? 2 : loader.getLibraries().size();
+    std::string placement_error = Arena::placementError(config, robots_per_match);
+    if (!placement_error.empty()) {
+        std::cerr << "\nERROR: " << placement_error << std::endl;
+        return 1;
+    }
+    
+    if (watch) {
+        Logger::setLevel(LogLevel::Warning);
+        RobotWatcher watcher(config, loader, builds);
+        return watcher.run();
+    }
+    
+    if (candidate >= 0) {
+        Logger::setLevel(LogLevel::Warning);
+        Sprt sprt(loader, config, candidate, baseline);
+        return sprt.run() == Sprt::UNDECIDED ? 2 : 0;
+    }
+    
+    if (tournament_repeats > 0) {
+        // Per-match setup chatter from many threads at once is just noise
+        Logger::setLevel(LogLevel::Warning);
+        Tournament tournament(loader, config);
+        tournament.run(tournament_repeats);
+        tournament.printStandings();
+        return 0;
+    }
+    
+    std::vector<std::shared_ptr<RobotBase>> robots;
+    for (size_t i = 0; i < loader.getLibraries().size(); i++) {
+        robots.push_back(loader.create(i, config));
+    }
+    
     std::cout << "\nSuccessfully loaded " << robots.size() << " robot(s)" << std::endl;
     
     // Create Arena and EventHandler
@@ -70,7 +258,46 @@ int main() {
     std::cout << "══════════════════════════════════════════════════════" << std::endl;
     
     Arena arena(config, robots);
-    EventHandler event_handler(arena);
+    if (analyze) {
+        Logger::flush();
+        arena.printArena();
+        analyzeArena(arena);
+        std::cout << "\nSeed: " << arena.getSeed() << std::endl;
+        return 0;
+    }
+    EventHandler event_handler(arena, config);
+    Logger::flush();
+    
+    // Declared before the recorder, which feeds spectators up to its END record
+    std::unique_ptr<SpectatorServer> spectators;
+    if (!config.spectator_socket.empty()) {
+        spectators = std::make_unique<SpectatorServer>(config);
+        if (!spectators->isOpen()) spectators.reset();
+    }
+    
+    std::unique_ptr<ReplayRecorder> recorder;
+    if (!config.replay_file.empty() || spectators) {
+        recorder = std::make_unique<ReplayRecorder>(config, arena);
+        recorder->setSpectators(spectators.get());
+        if (recorder->isActive()) {
+            event_handler.setRecorder(recorder.get());
+        }
+        if (spectators) spectators->poll(0, arena, *recorder);
+    }
+    
+    // Decision phase workers; tournaments and sweeps already keep every core busy
+    // with whole matches, so only a single match gets its own pool
+    std::unique_ptr<ThreadPool> decision_pool;
+    if (config.simultaneous_turns) {
+        decision_pool = std::make_unique<ThreadPool>(config.worker_threads);
+        event_handler.setThreadPool(decision_pool.get());
+    }
+    
+    std::unique_ptr<RobotProfiler> profiler;
+    if (config.profile_robots) {
+        profiler = std::make_unique<RobotProfiler>(robots.size());
+        event_handler.setProfiler(profiler.get());
+    }
     
     // Display initial state
     std::cout << "\n=== INITIAL STATE ===" << std::endl;
@@ -81,18 +308,20 @@ int main() {
     bool watch_live = config.watch_live;
     
     for (int round = 1; round <= max_rounds; round++) {
+        if (alloc_check && round == ALLOC_CHECK_WARMUP_ROUNDS + 1) {
+            AllocTracker::reset();
+            AllocTracker::enable(true);
+        }
+        
         // Print round header using EventHandler
         event_handler.printRoundHeader(round, max_rounds);
+        if (recorder) recorder->beginRound(round);
         
         // Process each robot's turn
-        for (size_t i = 0; i < robots.size(); i++) {
-            // Skip dead robots
-            if (robots[i]->get_health() <= 0) {
-                continue;
-            }
-            
-            event_handler.processRobotTurn(i, round);
-        }
+        event_handler.playRound(round);
+        
+        if (recorder) recorder->endRound(round, arena);
+        if (spectators) spectators->poll(round, arena, *recorder);
         
         // Display game state after all robots have moved
         event_handler.printGameState(round);
@@ -110,26 +339,48 @@ int main() {
         }
     }
     
+    AllocTracker::enable(false);
+    Logger::flush();
+    if (recorder) {
+        recorder->finish();
+        if (!config.replay_file.empty()) {
+            std::cout << "\nReplay written to " << config.replay_file << std::endl;
+        }
+    }
+    
     // Final state
     std::cout << "\n════════════════════ FINAL STATE ════════════════════" << std::endl;
     event_handler.printGameState(max_rounds);
     
+    std::cout << "\nSeed: " << arena.getSeed() << " (replay this match with --seed)" << std::endl;
+    
     // Winner announcement
     int alive_count = event_handler.countAliveRobots();
     if (alive_count == 1) {
-        // Find the winner
-        for (size_t i = 0; i < robots.size(); i++) {
-            if (robots[i]->get_health() > 0) {
-                std::cout << "\n🏆 WINNER: Robot " << i << " - " << robots[i]->m_name 
-                          << " (" << robots[i]->m_character << ")!" << std::endl;
-                break;
-            }
-        }
+        int winner = arena.getAliveRobots().front();
+        std::cout << "\n🏆 WINNER: Robot " << winner << " - " << robots[winner]->m_name 
+                  << " (" << robots[winner]->m_character << ")!" << std::endl;
     } else if (alive_count == 0) {
         std::cout << "\n💀 DRAW: All robots destroyed!" << std::endl;
     } else {
         std::cout << "\n⏱️  TIMEOUT: Multiple robots still alive after " << max_rounds << " rounds" << std::endl;
     }
     
+    if (profiler) {
+        std::vector<std::string> names;
+        for (const auto& robot : robots) names.push_back(robot->m_name);
+        profiler->printReport(names);
+    }
+    
+    if (alloc_check) {
+        long allocations = AllocTracker::count();
+        std::cout << "\nALLOC CHECK: " << allocations << " engine heap allocation(s) after "
+                  << ALLOC_CHECK_WARMUP_ROUNDS << " warm-up rounds" << std::endl;
+        if (allocations != 0) {
+            std::cerr << "ALLOC CHECK FAILED: steady-state rounds must not allocate" << std::endl;
+            return 1;
+        }
+    }
+    
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,326 @@
+// Engine regression tests. 'make check' builds and runs them; the engine's own
+// output goes to stdout, failures and the summary to stderr, and the exit code
+// is non-zero if any check failed.
+#include "Arena.h"
+#include "Config.h"
+#include "EventHandler.h"
+#include "FlowField.h"
+#include "Replay.h"
+#include "RobotBase.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int checks = 0;
+int failures = 0;
+
+#define CHECK(condition, what)                                                        \
+    do {                                                                              \
+        checks++;                                                                     \
+        if (!(condition)) {                                                           \
+            failures++;                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": FAILED " << (what) << std::endl; \
+        }                                                                             \
+    } while (0)
+
+using Cell = std::pair<int, int>;
+
+std::string describe(const std::set<Cell>& cells) {
+    std::string text;
+    for (const auto& cell : cells) text += "(" + std::to_string(cell.first) + "," + std::to_string(cell.second) + ")";
+    return text;
+}
+
+// Stands still and never shoots unless the test fires for it
+class DummyRobot : public RobotBase {
+public:
+    DummyRobot(char character, WeaponType weapon) : RobotBase(2, 0, weapon) {
+        m_name = "Dummy";
+        m_character = character;
+    }
+    void get_radar_direction(int& radar_direction) override { radar_direction = 0; }
+    void process_radar_results(const std::vector<RadarObj>&) override {}
+    bool get_shot_location(int&, int&) override { return false; }
+    void get_move_direction(int& direction, int& distance) override { direction = 0; distance = 0; }
+};
+
+// Sweeps its radar around, shoots the first robot it sees and wanders otherwise
+class BusyRobot : public RobotBase {
+private:
+    int turn_ = 0;
+    int target_row_ = -1;
+    int target_col_ = -1;
+
+public:
+    BusyRobot(char character, WeaponType weapon) : RobotBase(3, 2, weapon) {
+        m_name = "Busy";
+        m_character = character;
+    }
+    void get_radar_direction(int& radar_direction) override { radar_direction = turn_++ % 8 + 1; }
+    void process_radar_results(const std::vector<RadarObj>& radar_results) override {
+        target_row_ = -1;
+        for (const auto& object : radar_results) {
+            if (object.m_type == 'R') {
+                target_row_ = object.m_row;
+                target_col_ = object.m_col;
+                break;
+            }
+        }
+    }
+    bool get_shot_location(int& shot_row, int& shot_col) override {
+        if (target_row_ < 0) return false;
+        shot_row = target_row_;
+        shot_col = target_col_;
+        return true;
+    }
+    void get_move_direction(int& direction, int& distance) override {
+        direction = (turn_ * 5) % 8 + 1;
+        distance = turn_ % 3 + 1;
+    }
+};
+
+GameConfig emptyArena(int rows, int cols) {
+    GameConfig config;
+    config.rows = rows;
+    config.cols = cols;
+    config.area = rows * cols;
+    config.mounds = config.pits = config.flamethrowers = 0;
+    config.watch_live = false;
+    return config;
+}
+
+// Puts the shooter at 'from' and a robot on every cell of 'expected' and around
+// it, fires at 'target', and checks that exactly the expected cells were hit
+void checkShot(const char* name, WeaponType weapon, Cell from, Cell target, const std::set<Cell>& expected) {
+    const int rows = 12, cols = 12;
+    std::set<Cell> cells;
+    for (const auto& cell : expected) {
+        for (int dr = -1; dr <= 1; dr++) {
+            for (int dc = -1; dc <= 1; dc++) {
+                Cell near(cell.first + dr, cell.second + dc);
+                if (near != from && near.first >= 0 && near.first < rows && near.second >= 0 && near.second < cols) {
+                    cells.insert(near);
+                }
+            }
+        }
+    }
+    std::vector<Cell> positions = {from};
+    positions.insert(positions.end(), cells.begin(), cells.end());
+
+    std::vector<std::shared_ptr<RobotBase>> robots;
+    robots.push_back(std::make_shared<DummyRobot>('S', weapon));
+    for (size_t i = 1; i < positions.size(); i++) robots.push_back(std::make_shared<DummyRobot>('T', railgun));
+
+    GameConfig config = emptyArena(rows, cols);
+    Arena arena(config, robots);
+    // Twice: a robot moved onto a cell another robot has not left yet is
+    // overwritten when that one moves, and put back by the second pass
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < positions.size(); i++) {
+            arena.updateRobotPosition(i, positions[i].first, positions[i].second, false);
+        }
+    }
+
+    EventHandler event_handler(arena, config);
+    event_handler.processShot(0, target.first, target.second);
+
+    std::set<Cell> hit;
+    for (size_t i = 1; i < positions.size(); i++) {
+        if (robots[i]->get_health() < 100) hit.insert(positions[i]);
+    }
+    CHECK(hit == expected, std::string(name) + ": hit " + describe(hit) + ", expected " + describe(expected));
+    CHECK(robots[0]->get_health() == 100, std::string(name) + ": shooter hit itself");
+}
+
+void testShotPaths() {
+    // The spec's example: from (2,2) at (4,5) the rail goes on to the edge
+    checkShot("railgun", railgun, {2, 2}, {4, 5}, {{3, 3}, {3, 4}, {4, 5}, {5, 6}, {5, 7}, {6, 8}, {7, 9}, {7, 10}, {8, 11}});
+    // Straight up from the bottom row, through the whole column
+    std::set<Cell> column;
+    for (int row = 0; row < 11; row++) column.insert({row, 4});
+    checkShot("railgun straight", railgun, {11, 4}, {9, 4}, column);
+
+    // Grenades blow up a 3x3 box on the target, wherever it is
+    checkShot("grenade", grenade, {2, 2}, {7, 9}, {{6, 8}, {6, 9}, {6, 10}, {7, 8}, {7, 9}, {7, 10}, {8, 8}, {8, 9}, {8, 10}});
+    // Part of the box off the arena is simply lost
+    checkShot("grenade at the edge", grenade, {5, 5}, {0, 11}, {{0, 10}, {0, 11}, {1, 10}, {1, 11}});
+
+    // Flames are 3 wide and reach 4 cells, however far the target is
+    std::set<Cell> flame;
+    for (int col = 3; col <= 6; col++) {
+        for (int row = 4; row <= 6; row++) flame.insert({row, col});
+    }
+    checkShot("flamethrower", flamethrower, {5, 2}, {5, 11}, flame);
+
+    // The hammer reaches only the adjacent cell toward the target
+    checkShot("hammer", hammer, {5, 5}, {9, 9}, {{6, 6}});
+}
+
+struct RoundState {
+    std::vector<char> grid;
+    std::vector<Replay::RobotState> robots;
+};
+
+RoundState captureRound(const Arena& arena, const std::vector<std::shared_ptr<RobotBase>>& robots) {
+    RoundState state;
+    for (int row = 0; row < arena.getRows(); row++) {
+        for (int col = 0; col < arena.getCols(); col++) state.grid.push_back(arena.getCell(row, col));
+    }
+    for (const auto& robot : robots) {
+        Replay::RobotState robot_state{};
+        robot->get_current_location(robot_state.row, robot_state.col);
+        robot_state.health = robot->get_health();
+        robot_state.armor = robot->get_armor();
+        robot_state.move = robot->get_move_speed();
+        robot_state.grenades = robot->get_grenades();
+        state.robots.push_back(robot_state);
+    }
+    return state;
+}
+
+// Plays and records a match, keeping the live state after every round, then
+// seeks the replay to every round out of order and compares
+void testReplaySeek() {
+    GameConfig config;
+    config.rows = 15;
+    config.cols = 17;
+    config.area = config.rows * config.cols;
+    config.mounds = config.area * 8 / 100;
+    config.pits = config.area * 3 / 100;
+    config.flamethrowers = config.area * 4 / 100;
+    config.watch_live = false;
+    config.replay_file = "test_engine_replay.rwr";
+    config.replay_keyframe_interval = 7;
+    const int rounds = 60;
+
+    std::vector<std::shared_ptr<RobotBase>> robots;
+    const WeaponType weapons[] = {railgun, grenade, flamethrower, hammer, railgun, grenade};
+    for (int i = 0; i < 6; i++) robots.push_back(std::make_shared<BusyRobot>('A' + i, weapons[i]));
+
+    std::vector<RoundState> live;
+    {
+        Arena arena(config, robots);
+        EventHandler event_handler(arena, config);
+        ReplayRecorder recorder(config, arena);
+        CHECK(recorder.isOpen(), "replay file opens for writing");
+        event_handler.setRecorder(&recorder);
+        live.push_back(captureRound(arena, robots));
+        for (int round = 1; round <= rounds; round++) {
+            recorder.beginRound(round);
+            for (size_t i = 0; i < robots.size(); i++) {
+                if (robots[i]->get_health() > 0) event_handler.processRobotTurn(i, round);
+            }
+            recorder.endRound(round, arena);
+            live.push_back(captureRound(arena, robots));
+        }
+        recorder.finish();
+    }
+
+    ReplayPlayer player;
+    CHECK(player.open(config.replay_file), "replay opens");
+    CHECK(player.getLastRound() == rounds, "last round is " + std::to_string(player.getLastRound()));
+
+    std::vector<int> order(rounds + 1);
+    for (int round = 0; round <= rounds; round++) order[round] = round;
+    std::shuffle(order.begin(), order.end(), std::mt19937(8));
+    for (int round : order) {
+        if (!player.seek(round)) {
+            CHECK(false, "seek to round " + std::to_string(round));
+            continue;
+        }
+        const RoundState& expected = live[round];
+        bool grid_matches = true;
+        for (int row = 0; row < config.rows; row++) {
+            for (int col = 0; col < config.cols; col++) {
+                grid_matches = grid_matches && player.getCell(row, col) == expected.grid[row * config.cols + col];
+            }
+        }
+        CHECK(grid_matches, "grid after seeking to round " + std::to_string(round));
+
+        const auto& states = player.getRobotStates();
+        bool robots_match = states.size() == expected.robots.size();
+        for (size_t i = 0; robots_match && i < states.size(); i++) {
+            const Replay::RobotState& a = states[i];
+            const Replay::RobotState& b = expected.robots[i];
+            robots_match = a.row == b.row && a.col == b.col && a.health == b.health && a.armor == b.armor &&
+                           a.move == b.move && a.grenades == b.grenades;
+        }
+        CHECK(robots_match, "robots after seeking to round " + std::to_string(round));
+    }
+    std::remove(config.replay_file.c_str());
+}
+
+// Random cost and goal edits: update() after each batch has to match a field
+// recomputed from scratch with the same inputs
+void testFlowFieldRepair() {
+    const int rows = 23, cols = 31;
+    const uint8_t costs[] = {0, 1, 1, 1, 1, 2, 8};
+    std::mt19937 rng(24);
+    FlowField incremental(rows, cols), reference(rows, cols);
+    auto setCost = [&](int row, int col, uint8_t cost) {
+        incremental.setCost(row, col, cost);
+        reference.setCost(row, col, cost);
+    };
+    auto setGoal = [&](int row, int col, bool goal) {
+        incremental.setGoal(row, col, goal);
+        reference.setGoal(row, col, goal);
+    };
+
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) setCost(row, col, costs[rng() % 7]);
+    }
+    setGoal(rows / 2, cols / 2, true);
+    incremental.update();
+
+    int mismatched_steps = 0;
+    for (int step = 0; step < 300; step++) {
+        int changes = 1 + rng() % 6;
+        for (int k = 0; k < changes; k++) {
+            int row = rng() % rows, col = rng() % cols;
+            switch (rng() % 8) {
+                case 0: setGoal(row, col, true); break;
+                case 1: setGoal(row, col, false); break;
+                case 2:
+                    if (step % 50 == 49) {
+                        incremental.clearGoals();
+                        reference.clearGoals();
+                        setGoal(row, col, true);
+                    }
+                    break;
+                default: setCost(row, col, costs[rng() % 7]); break;
+            }
+        }
+        incremental.update();
+        reference.invalidate();
+        reference.update();
+
+        bool matches = true;
+        for (int row = 0; row < rows; row++) {
+            for (int col = 0; col < cols; col++) {
+                matches = matches && incremental.distance(row, col) == reference.distance(row, col) &&
+                          incremental.direction(row, col) == reference.direction(row, col);
+            }
+        }
+        mismatched_steps += !matches;
+    }
+    CHECK(mismatched_steps == 0, std::to_string(mismatched_steps) + " of 300 incremental updates differ from a full solve");
+}
+
+}
+
+int main() {
+    testShotPaths();
+    testReplaySeek();
+    testFlowFieldRepair();
+
+    std::cerr << "Engine tests: " << checks - failures << " of " << checks << " checks passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}